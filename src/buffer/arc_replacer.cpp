@@ -0,0 +1,232 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+ARCReplacer::ARCReplacer(size_t num_pages) : capacity_(num_pages) { frames_.reserve(num_pages); }
+
+ARCReplacer::~ARCReplacer() = default;
+
+bool ARCReplacer::Victim(frame_id_t *frame_id) {
+  std::scoped_lock lock{latch_};
+  if (evictable_count_ == 0) {
+    return false;
+  }
+  // REPLACE: evict from T1 while it is larger than its target, otherwise from T2.
+  bool from_t1;
+  if (!t1_.empty() && t1_.size() > target_t1_size_) {
+    from_t1 = FindEvictable(t1_, frame_id);
+    if (!from_t1) {
+      FindEvictable(t2_, frame_id);
+    }
+  } else {
+    from_t1 = !FindEvictable(t2_, frame_id);
+    if (from_t1) {
+      FindEvictable(t1_, frame_id);
+    }
+  }
+
+  page_id_t page_id = frames_[*frame_id].page_id_;
+  Erase(*frame_id);
+  if (page_id != INVALID_PAGE_ID) {
+    auto &ghosts = from_t1 ? b1_ : b2_;
+    auto &map = from_t1 ? b1_map_ : b2_map_;
+    ghosts.push_front(page_id);
+    map[page_id] = ghosts.begin();
+    TrimGhosts();
+  }
+  return true;
+}
+
+void ARCReplacer::Pin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  auto iter = frames_.find(frame_id);
+  if (iter == frames_.end()) {
+    Insert(frame_id, INVALID_PAGE_ID, false);
+    return;
+  }
+  FrameEntry &entry = iter->second;
+  if (entry.evictable_) {
+    entry.evictable_ = false;
+    evictable_count_--;
+  }
+  // The reference the page was loaded for, or the first fetch of a page that was read ahead.
+  if (entry.fresh_) {
+    entry.fresh_ = false;
+    return;
+  }
+  // A hit on a resident page: it moves to the MRU end of T2.
+  (entry.in_t2_ ? t2_ : t1_).erase(entry.pos_);
+  t2_.push_front(frame_id);
+  entry.in_t2_ = true;
+  entry.pos_ = t2_.begin();
+}
+
+void ARCReplacer::Unpin(frame_id_t frame_id) { SetEvictable(frame_id, true); }
+
+void ARCReplacer::SetEvictable(frame_id_t frame_id, bool evictable) {
+  std::scoped_lock lock{latch_};
+  auto iter = frames_.find(frame_id);
+  if (iter == frames_.end()) {
+    Insert(frame_id, INVALID_PAGE_ID, false);
+    iter = frames_.find(frame_id);
+  }
+  FrameEntry &entry = iter->second;
+  if (entry.evictable_ != evictable) {
+    entry.evictable_ = evictable;
+    if (evictable) {
+      evictable_count_++;
+    } else {
+      evictable_count_--;
+    }
+  }
+}
+
+size_t ARCReplacer::Size() {
+  std::scoped_lock lock{latch_};
+  return evictable_count_;
+}
+
+void ARCReplacer::RecordPage(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock lock{latch_};
+  // The frame's previous page left the buffer pool without being victimized (e.g. it was deleted): no ghost.
+  if (frames_.count(frame_id) != 0) {
+    Erase(frame_id);
+  }
+
+  bool in_t2 = false;
+  if (b1_map_.count(page_id) != 0) {
+    // A miss that a larger T1 would have turned into a hit.
+    size_t delta = std::max<size_t>(b2_.size() / b1_.size(), 1);
+    target_t1_size_ = std::min(capacity_, target_t1_size_ + delta);
+    EraseGhost(&b1_, &b1_map_, page_id);
+    in_t2 = true;
+  } else if (b2_map_.count(page_id) != 0) {
+    // A miss that a larger T2 would have turned into a hit.
+    size_t delta = std::max<size_t>(b1_.size() / b2_.size(), 1);
+    target_t1_size_ -= std::min(target_t1_size_, delta);
+    EraseGhost(&b2_, &b2_map_, page_id);
+    in_t2 = true;
+  }
+  Insert(frame_id, page_id, in_t2);
+  frames_[frame_id].fresh_ = true;
+  TrimGhosts();
+}
+
+void ARCReplacer::PeekVictims(size_t max_frames, std::vector<frame_id_t> *frames) {
+  std::scoped_lock lock{latch_};
+  std::vector<frame_id_t> t1_evictable;
+  std::vector<frame_id_t> t2_evictable;
+  for (auto iter = t1_.rbegin(); iter != t1_.rend(); ++iter) {
+    if (frames_[*iter].evictable_) {
+      t1_evictable.push_back(*iter);
+    }
+  }
+  for (auto iter = t2_.rbegin(); iter != t2_.rend(); ++iter) {
+    if (frames_[*iter].evictable_) {
+      t2_evictable.push_back(*iter);
+    }
+  }
+  // Replays REPLACE as in Victim, with T1 shrinking as its frames are taken.
+  size_t t1_size = t1_.size();
+  size_t i = 0;
+  size_t j = 0;
+  while (frames->size() < max_frames && (i < t1_evictable.size() || j < t2_evictable.size())) {
+    bool from_t1 = (t1_size > target_t1_size_ && i < t1_evictable.size()) || j == t2_evictable.size();
+    if (from_t1) {
+      frames->push_back(t1_evictable[i++]);
+      t1_size--;
+    } else {
+      frames->push_back(t2_evictable[j++]);
+    }
+  }
+}
+
+size_t ARCReplacer::GetTargetT1Size() {
+  std::scoped_lock lock{latch_};
+  return target_t1_size_;
+}
+
+void ARCReplacer::Insert(frame_id_t frame_id, page_id_t page_id, bool in_t2) {
+  auto &list = in_t2 ? t2_ : t1_;
+  list.push_front(frame_id);
+  FrameEntry &entry = frames_[frame_id];
+  entry.page_id_ = page_id;
+  entry.in_t2_ = in_t2;
+  entry.pos_ = list.begin();
+  entry.evictable_ = false;
+  entry.fresh_ = false;
+}
+
+void ARCReplacer::Erase(frame_id_t frame_id) {
+  FrameEntry &entry = frames_[frame_id];
+  (entry.in_t2_ ? t2_ : t1_).erase(entry.pos_);
+  if (entry.evictable_) {
+    evictable_count_--;
+  }
+  frames_.erase(frame_id);
+}
+
+bool ARCReplacer::FindEvictable(const std::list<frame_id_t> &list, frame_id_t *frame_id) {
+  for (auto iter = list.rbegin(); iter != list.rend(); ++iter) {
+    if (frames_[*iter].evictable_) {
+      *frame_id = *iter;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ARCReplacer::Resize(size_t num_pages) {
+  std::scoped_lock lock{latch_};
+  // Frames past the new size are gone for good; their pages are not worth remembering as ghosts either.
+  std::vector<frame_id_t> removed;
+  for (const auto &[frame_id, entry] : frames_) {
+    if (static_cast<size_t>(frame_id) >= num_pages) {
+      removed.push_back(frame_id);
+    }
+  }
+  for (frame_id_t frame_id : removed) {
+    Erase(frame_id);
+  }
+  capacity_ = num_pages;
+  target_t1_size_ = std::min(target_t1_size_, capacity_);
+  TrimGhosts();
+}
+
+bool ARCReplacer::EraseGhost(std::list<page_id_t> *ghosts,
+                             std::unordered_map<page_id_t, std::list<page_id_t>::iterator> *map, page_id_t page_id) {
+  auto iter = map->find(page_id);
+  if (iter == map->end()) {
+    return false;
+  }
+  ghosts->erase(iter->second);
+  map->erase(iter);
+  return true;
+}
+
+void ARCReplacer::TrimGhosts() {
+  while (t1_.size() + b1_.size() > capacity_ && !b1_.empty()) {
+    b1_map_.erase(b1_.back());
+    b1_.pop_back();
+  }
+  while (t1_.size() + t2_.size() + b1_.size() + b2_.size() > 2 * capacity_ && !b2_.empty()) {
+    b2_map_.erase(b2_.back());
+    b2_.pop_back();
+  }
+}
+
+}  // namespace bustub
@@ -12,29 +12,49 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <exception>
+#include <future>  // NOLINT
 #include <list>
+#include <memory>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace bustub {
 
-BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
+BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager,
+                                     Replacer *replacer)
+    : pool_size_(pool_size),
+      disk_manager_(disk_manager),
+      page_size_(disk_manager->GetPageSize()),
+      log_manager_(log_manager),
+      replacer_(replacer) {
   // We allocate a consecutive memory space for the buffer pool.
-  pages_ = new Page[pool_size_];
-  replacer_ = new LRUReplacer(pool_size);
+  AllocateFrames(pool_size_);
+  if (replacer_ == nullptr) {
+    replacer_ = new LRUReplacer(pool_size);
+  }
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
     free_list_.emplace_back(static_cast<int>(i));
   }
+
+  if (pool_size_ > 0) {
+    page_cleaner_ = std::thread(&BufferPoolManager::RunPageCleaner, this);
+  }
 }
 
 BufferPoolManager::~BufferPoolManager() {
-  delete[] pages_;
+  StopPageCleaner();
+  StopPrefetchThreads();
   delete replacer_;
 }
 
-Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
+Page *BufferPoolManager::FetchPageImpl(page_id_t page_id, BufferRing *ring, bool reference) {
   // 1.     Search the page table for the requested page (P).
   // 1.1    If P exists, pin it and return it immediately.
   // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
@@ -42,14 +62,192 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
   // 2.     If R is dirty, write it back to the disk.
   // 3.     Delete R from the page table and insert P.
   // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
-  return nullptr;
+  // The disk I/O of steps 2 and 4 happens without latch_; the frame is marked as I/O in progress meanwhile.
+  // A query over its quota recycles its own frames in step 1.2, a scan the frames of its ring.
+  BufferQuota *quota = BufferQuota::Current();
+  std::unique_lock lock{latch_};
+  TracePageAccess(page_id, PageAccessType::FETCH);
+  while (true) {
+    auto iter = page_table_.find(page_id);
+    if (iter != page_table_.end()) {
+      Page *page = frames_[iter->second];
+      page->pin_count_++;
+      if (reference) {
+        replacer_->Pin(iter->second);
+      } else {
+        replacer_->SetEvictable(iter->second, false);
+      }
+      BufferPoolCounters::Increment(&counters_.hits_);
+      // A page that was read ahead for a scan belongs to the scan's ring, as if the scan had read it in itself.
+      if (page->prefetched_ && ring != nullptr) {
+        RecordRingFrame(ring, iter->second, page_id);
+      }
+      if (quota != nullptr) {
+        TouchQuotaFrame(quota, iter->second, page_id);
+      }
+      page->prefetched_ = false;
+      // Another thread may still be reading the page in; only this frame is waited for.
+      if (page->io_in_progress_) {
+        BufferPoolCounters::Increment(&counters_.pin_waits_);
+        page->io_cv_.wait(lock, [page] { return !page->io_in_progress_; });
+        // The read failed and the frame was given up; try the read again.
+        if (page->page_id_ != page_id) {
+          UnpinFrame(page->frame_id_);
+          continue;
+        }
+      }
+      return page;
+    }
+    // The page may still be on its way to disk from a frame that was just handed to another page. Reading it before
+    // that write completes would return stale data.
+    auto evicting = evicting_pages_.find(page_id);
+    if (evicting != evicting_pages_.end()) {
+      Page *frame = frames_[evicting->second];
+      BufferPoolCounters::Increment(&counters_.pin_waits_);
+      frame->io_cv_.wait(lock, [this, page_id] { return evicting_pages_.count(page_id) == 0; });
+      continue;
+    }
+    // The same holds for the copy of the page the page cleaner may be writing.
+    if (cleaning_pages_.count(page_id) == 0) {
+      break;
+    }
+    BufferPoolCounters::Increment(&counters_.pin_waits_);
+    cleaning_cv_.wait(lock, [this, page_id] { return cleaning_pages_.count(page_id) == 0; });
+  }
+
+  BufferPoolCounters::Increment(&counters_.misses_);
+  frame_id_t frame_id;
+  page_id_t victim_page_id;
+  bool from_ring = ring != nullptr && FindRingFrame(ring, &frame_id, &victim_page_id);
+  if (!from_ring && !FindQuotaOrFreeFrame(quota, &frame_id, &victim_page_id)) {
+    return nullptr;
+  }
+  if (ring != nullptr) {
+    RecordRingFrame(ring, frame_id, page_id);
+  }
+  if (quota != nullptr) {
+    RecordQuotaFrame(quota, frame_id, page_id);
+  }
+  Page *page = InstallNewPage(frame_id, page_id);
+  if (reference) {
+    replacer_->Pin(frame_id);
+  }
+  LoadFrame(&lock, page, victim_page_id, true);
+  return page;
+}
+
+bool BufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
+  std::scoped_lock lock{latch_};
+  auto iter = page_table_.find(page_id);
+  if (iter == page_table_.end()) {
+    return false;
+  }
+  Page *page = frames_[iter->second];
+  if (page->pin_count_ <= 0) {
+    return false;
+  }
+  page->is_dirty_ |= is_dirty;
+  UnpinFrame(iter->second);
+  return true;
+}
+
+Page *BufferPoolManager::FetchChildPageImpl(Page *parent, int slot, page_id_t child_id) {
+  std::atomic<frame_id_t> *child_frames = nullptr;
+  if (slot >= 0 && static_cast<size_t>(slot) < parent->MaxChildSlots()) {
+    child_frames = parent->child_frames_.load(std::memory_order_acquire);
+    if (child_frames == nullptr) {
+      auto *fresh = new std::atomic<frame_id_t>[parent->MaxChildSlots()];
+      for (size_t i = 0; i < parent->MaxChildSlots(); i++) {
+        fresh[i].store(INVALID_FRAME_ID, std::memory_order_relaxed);
+      }
+      // Another thread may have allocated the table of the same parent meanwhile.
+      if (parent->child_frames_.compare_exchange_strong(child_frames, fresh, std::memory_order_acq_rel)) {
+        child_frames = fresh;
+      } else {
+        delete[] fresh;
+      }
+    }
+
+    frame_id_t frame_id = child_frames[slot].load(std::memory_order_relaxed);
+    std::unique_lock lock{latch_};
+    // Frames past pool_size_ are being removed by Resize and no longer in the page table.
+    if (frame_id != INVALID_FRAME_ID && static_cast<size_t>(frame_id) < pool_size_ &&
+        frames_[frame_id]->page_id_ == child_id) {
+      TracePageAccess(child_id, PageAccessType::FETCH);
+      Page *page = frames_[frame_id];
+      page->pin_count_++;
+      replacer_->Pin(frame_id);
+      BufferPoolCounters::Increment(&counters_.hits_);
+      page->prefetched_ = false;
+      if (page->io_in_progress_) {
+        BufferPoolCounters::Increment(&counters_.pin_waits_);
+        page->io_cv_.wait(lock, [page] { return !page->io_in_progress_; });
+      }
+      if (page->page_id_ == child_id) {
+        return page;
+      }
+      UnpinFrame(frame_id);
+    }
+  }
+
+  Page *page = FetchPageImpl(child_id);
+  if (page != nullptr && child_frames != nullptr) {
+    child_frames[slot].store(page->frame_id_, std::memory_order_relaxed);
+  }
+  return page;
 }
 
-bool BufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) { return false; }
+bool BufferPoolManager::UnpinPageImpl(Page *page, bool is_dirty) {
+  std::scoped_lock lock{latch_};
+  frame_id_t frame_id = page->frame_id_;
+  if (frame_id == INVALID_FRAME_ID || static_cast<size_t>(frame_id) >= frames_.size() || frames_[frame_id] != page ||
+      page->pin_count_ <= 0) {
+    return false;
+  }
+  page->is_dirty_ |= is_dirty;
+  UnpinFrame(frame_id);
+  return true;
+}
 
 bool BufferPoolManager::FlushPageImpl(page_id_t page_id) {
   // Make sure you call DiskManager::WritePage!
-  return false;
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  std::unique_lock lock{latch_};
+  auto iter = page_table_.find(page_id);
+  if (iter == page_table_.end()) {
+    return false;
+  }
+  frame_id_t frame_id = iter->second;
+  Page *page = frames_[frame_id];
+  // Pin the page for the duration of the write so that it cannot be evicted once latch_ is released. The write is not
+  // a reference to the page, so the replacer only holds the frame.
+  page->pin_count_++;
+  replacer_->SetEvictable(frame_id, false);
+  page->io_cv_.wait(lock, [page] { return !page->io_in_progress_; });
+  // An older copy of the page written by the page cleaner must not land after this write.
+  cleaning_cv_.wait(lock, [this, page_id] { return cleaning_pages_.count(page_id) == 0; });
+  // The page could not be read in and is gone from the pool.
+  if (page->page_id_ != page_id) {
+    UnpinFrame(frame_id);
+    return false;
+  }
+  // Clearing the flag first means a concurrent UnpinPage(is_dirty = true) during the write is not lost.
+  page->is_dirty_ = false;
+  lock.unlock();
+
+  // Other threads may change the pinned page meanwhile. The copy taken under the page latch is consistent, and the
+  // disk manager stamps the checksum into it instead of into the frame.
+  AlignedBuffer copy = AlignedMemory::Allocate(page_size_);
+  page->RLatch();
+  memcpy(copy.get(), page->GetData(), page_size_);
+  page->RUnlatch();
+  WriteToDisk(page_id, copy.get());
+
+  lock.lock();
+  UnpinFrame(frame_id);
+  return true;
 }
 
 Page *BufferPoolManager::NewPageImpl(page_id_t *page_id) {
@@ -58,7 +256,53 @@ Page *BufferPoolManager::NewPageImpl(page_id_t *page_id) {
   // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
   // 3.   Update P's metadata, zero out memory and add P to the page table.
   // 4.   Set the page ID output parameter. Return a pointer to P.
-  return nullptr;
+  BufferQuota *quota = BufferQuota::Current();
+  std::unique_lock lock{latch_};
+  *page_id = disk_manager_->AllocatePage();
+  // The id may belong to a deleted page whose last eviction is still being written. The wait releases latch_, so it
+  // comes before a frame is taken: the victim keeps its old page id until InstallNewPage and must not be seen then.
+  WaitForPageWrites(&lock, *page_id);
+  Page *stale = TakeOverStaleCopy(&lock, *page_id, quota);
+  if (stale != nullptr) {
+    return stale;
+  }
+  frame_id_t frame_id;
+  page_id_t victim_page_id;
+  if (!FindQuotaOrFreeFrame(quota, &frame_id, &victim_page_id)) {
+    disk_manager_->DeallocatePage(*page_id);
+    return nullptr;
+  }
+  TracePageAccess(*page_id, PageAccessType::NEW);
+  if (quota != nullptr) {
+    RecordQuotaFrame(quota, frame_id, *page_id);
+  }
+  Page *page = InstallNewPage(frame_id, *page_id);
+  replacer_->Pin(frame_id);
+  LoadFrame(&lock, page, victim_page_id, false);
+  return page;
+}
+
+Page *BufferPoolManager::NewPageWithIdImpl(page_id_t page_id) {
+  BufferQuota *quota = BufferQuota::Current();
+  std::unique_lock lock{latch_};
+  WaitForPageWrites(&lock, page_id);
+  Page *stale = TakeOverStaleCopy(&lock, page_id, quota);
+  if (stale != nullptr) {
+    return stale;
+  }
+  frame_id_t frame_id;
+  page_id_t victim_page_id;
+  if (!FindQuotaOrFreeFrame(quota, &frame_id, &victim_page_id)) {
+    return nullptr;
+  }
+  TracePageAccess(page_id, PageAccessType::NEW);
+  if (quota != nullptr) {
+    RecordQuotaFrame(quota, frame_id, page_id);
+  }
+  Page *page = InstallNewPage(frame_id, page_id);
+  replacer_->Pin(frame_id);
+  LoadFrame(&lock, page, victim_page_id, false);
+  return page;
 }
 
 bool BufferPoolManager::DeletePageImpl(page_id_t page_id) {
@@ -67,11 +311,804 @@ bool BufferPoolManager::DeletePageImpl(page_id_t page_id) {
   // 1.   If P does not exist, return true.
   // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
-  return false;
+  return RemovePage(page_id, false);
+}
+
+void BufferPoolManager::DeletePageWhenUnpinnedImpl(page_id_t page_id) { RemovePage(page_id, true); }
+
+bool BufferPoolManager::RemovePage(page_id_t page_id, bool when_unpinned) {
+  // Deallocating P while an older copy of it is still being written would let that write land on the next page that
+  // gets the id.
+  std::unique_lock lock{latch_};
+  WaitForPageWrites(&lock, page_id);
+  auto iter = page_table_.find(page_id);
+  if (iter == page_table_.end()) {
+    disk_manager_->DeallocatePage(page_id);
+    return true;
+  }
+  frame_id_t frame_id = iter->second;
+  Page *page = frames_[frame_id];
+  if (page->pin_count_ > 0) {
+    page->delete_pending_ |= when_unpinned;
+    return false;
+  }
+  page_table_.erase(iter);
+  // Holding the frame in the replacer makes sure that it can never be handed out twice.
+  replacer_->SetEvictable(frame_id, false);
+  page->page_id_ = INVALID_PAGE_ID;
+  page->is_dirty_ = false;
+  page->ResetMemory();
+  ReleaseFrame(frame_id);
+  disk_manager_->DeallocatePage(page_id);
+  return true;
 }
 
 void BufferPoolManager::FlushAllPagesImpl() {
-  // You can do it!
+  FlushDirtyPages();
+  disk_manager_->SyncPages();
+}
+
+void BufferPoolManager::FlushDirtyPages() {
+  std::unique_lock lock{latch_};
+  std::vector<frame_id_t> batch;
+  std::vector<std::pair<page_id_t, const char *>> pages;
+  AlignedBuffer buffer;
+  // Frames that are being removed by a Resize may still hold dirty pages.
+  for (size_t i = 0; i <= frames_.size(); i++) {
+    if (batch.size() == FLUSH_BATCH_PAGES || (i == frames_.size() && !batch.empty())) {
+      // The pins keep the pages in their frames while they are written without latch_. As in FlushPageImpl, copies
+      // taken under the page latches are written, since the pages may be changed meanwhile.
+      if (buffer == nullptr) {
+        buffer = AlignedMemory::Allocate(FLUSH_BATCH_PAGES * page_size_);
+      }
+      std::vector<Page *> sources;
+      pages.clear();
+      for (frame_id_t frame_id : batch) {
+        sources.push_back(frames_[frame_id]);
+        pages.emplace_back(frames_[frame_id]->page_id_, buffer.get() + pages.size() * page_size_);
+      }
+      lock.unlock();
+      for (size_t j = 0; j < sources.size(); j++) {
+        sources[j]->RLatch();
+        memcpy(buffer.get() + j * page_size_, sources[j]->GetData(), page_size_);
+        sources[j]->RUnlatch();
+      }
+      WriteBatchToDisk(&pages);
+      lock.lock();
+      for (frame_id_t frame_id : batch) {
+        UnpinFrame(frame_id);
+      }
+      batch.clear();
+    }
+    if (i == frames_.size()) {
+      break;
+    }
+    Page *page = frames_[i];
+    // An older copy of the page written by the page cleaner must not land after this write.
+    while (page->io_in_progress_ || cleaning_pages_.count(page->page_id_) > 0) {
+      page->io_cv_.wait(lock, [page] { return !page->io_in_progress_; });
+      cleaning_cv_.wait(lock, [this, page] { return cleaning_pages_.count(page->page_id_) == 0; });
+    }
+    if (page->page_id_ == INVALID_PAGE_ID || !page->is_dirty_) {
+      continue;
+    }
+    page->pin_count_++;
+    // A retiring frame has left the replacer already and must not be added back.
+    if (i < pool_size_) {
+      replacer_->SetEvictable(static_cast<frame_id_t>(i), false);
+    }
+    // Clearing the flag first means a concurrent UnpinPage(is_dirty = true) during the write is not lost.
+    page->is_dirty_ = false;
+    batch.push_back(static_cast<frame_id_t>(i));
+  }
+}
+
+void BufferPoolManager::PrefetchPages(const std::vector<page_id_t> &page_ids) {
+  std::vector<PrefetchRequest> requests;
+  requests.reserve(page_ids.size());
+  for (page_id_t page_id : page_ids) {
+    requests.push_back({page_id, 1, nullptr});
+  }
+  EnqueuePrefetchRequests(requests);
+}
+
+void BufferPoolManager::PrefetchPageChain(page_id_t page_id, size_t num_pages, page_link_fn next_page) {
+  if (page_id == INVALID_PAGE_ID || num_pages == 0) {
+    return;
+  }
+  EnqueuePrefetchRequests({{page_id, num_pages, next_page}});
+}
+
+bool BufferPoolManager::PrefetchPageImpl(page_id_t page_id, page_link_fn next_page, page_id_t *next_page_id) {
+  *next_page_id = INVALID_PAGE_ID;
+  std::unique_lock lock{latch_};
+  // A page that is still being written back will be fetched from its new frame anyway; it is not worth waiting for.
+  if (evicting_pages_.count(page_id) > 0 || cleaning_pages_.count(page_id) > 0) {
+    return false;
+  }
+  frame_id_t frame_id;
+  Page *page;
+  auto iter = page_table_.find(page_id);
+  if (iter != page_table_.end()) {
+    if (next_page == nullptr) {
+      return true;
+    }
+    frame_id = iter->second;
+    page = frames_[frame_id];
+    page->pin_count_++;
+    replacer_->SetEvictable(frame_id, false);
+    page->io_cv_.wait(lock, [page] { return !page->io_in_progress_; });
+    if (page->page_id_ != page_id) {
+      UnpinFrame(frame_id);
+      return false;
+    }
+  } else {
+    page_id_t victim_page_id;
+    if (!FindFreeFrame(&frame_id, &victim_page_id)) {
+      return false;
+    }
+    page = InstallNewPage(frame_id, page_id);
+    try {
+      LoadFrame(&lock, page, victim_page_id, true);
+    } catch (const Exception &) {
+      // A page that cannot be read is reported by the fetch that needs it.
+      return false;
+    }
+    page->prefetched_ = true;
+  }
+
+  // The page is pinned, so its link can be read without latch_. The page latch guards against concurrent writers.
+  if (next_page != nullptr) {
+    lock.unlock();
+    page->RLatch();
+    *next_page_id = next_page(page);
+    page->RUnlatch();
+    lock.lock();
+  }
+  UnpinFrame(frame_id);
+  return true;
+}
+
+void BufferPoolManager::PrefetchBatchImpl(const std::vector<page_id_t> &page_ids) {
+  std::unique_lock lock{latch_};
+  std::vector<frame_id_t> frame_ids;
+  // A concurrent Resize may reallocate frames_, so the pages are looked up while latch_ is held.
+  std::vector<Page *> pages;
+  std::vector<page_id_t> victim_page_ids;
+  for (page_id_t page_id : page_ids) {
+    if (page_table_.count(page_id) > 0 || evicting_pages_.count(page_id) > 0 || cleaning_pages_.count(page_id) > 0) {
+      continue;
+    }
+    frame_id_t frame_id;
+    page_id_t victim_page_id;
+    if (!FindFreeFrame(&frame_id, &victim_page_id)) {
+      break;
+    }
+    pages.push_back(InstallNewPage(frame_id, page_id));
+    frame_ids.push_back(frame_id);
+    victim_page_ids.push_back(victim_page_id);
+  }
+  if (frame_ids.empty()) {
+    return;
+  }
+  // The victims were dirtied again after the page cleaner copied them; those copies must land first.
+  for (page_id_t victim_page_id : victim_page_ids) {
+    if (victim_page_id != INVALID_PAGE_ID) {
+      cleaning_cv_.wait(lock, [this, victim_page_id] { return cleaning_pages_.count(victim_page_id) == 0; });
+    }
+  }
+  lock.unlock();
+
+  // The dirty victims still occupy their frames, so they are written back before the reads replace them.
+  std::vector<std::pair<page_id_t, const char *>> victims;
+  std::vector<std::pair<page_id_t, char *>> reads;
+  for (size_t i = 0; i < frame_ids.size(); i++) {
+    Page *page = pages[i];
+    if (victim_page_ids[i] != INVALID_PAGE_ID) {
+      victims.emplace_back(victim_page_ids[i], page->GetData());
+    }
+    reads.emplace_back(page->page_id_, page->GetData());
+  }
+  WriteBatchToDisk(&victims);
+  std::vector<bool> read = ReadBatchFromDisk(reads);
+
+  lock.lock();
+  for (size_t i = 0; i < frame_ids.size(); i++) {
+    Page *page = pages[i];
+    if (victim_page_ids[i] != INVALID_PAGE_ID) {
+      evicting_pages_.erase(victim_page_ids[i]);
+    }
+    if (!read[i]) {
+      DropFrame(page);
+    }
+    page->io_in_progress_ = false;
+    page->io_cv_.notify_all();
+    page->prefetched_ = read[i];
+    UnpinFrame(frame_ids[i]);
+  }
+}
+
+void BufferPoolManager::EnqueuePrefetchRequests(const std::vector<PrefetchRequest> &requests) {
+  std::scoped_lock lock{prefetch_latch_};
+  if (stop_prefetch_) {
+    return;
+  }
+  if (prefetch_threads_.empty()) {
+    for (int i = 0; i < PREFETCH_THREADS; i++) {
+      prefetch_threads_.emplace_back(&BufferPoolManager::RunPrefetchThread, this);
+    }
+  }
+  prefetch_queue_.insert(prefetch_queue_.end(), requests.begin(), requests.end());
+  prefetch_cv_.notify_all();
+}
+
+void BufferPoolManager::RunPrefetchThread() {
+  std::unique_lock lock{prefetch_latch_};
+  while (true) {
+    prefetch_cv_.wait(lock, [this] { return stop_prefetch_ || !prefetch_queue_.empty(); });
+    if (stop_prefetch_) {
+      return;
+    }
+    PrefetchRequest request = prefetch_queue_.front();
+    prefetch_queue_.pop_front();
+    // The pages of PrefetchPages are read in batches, so that many reads are in flight at once.
+    if (request.next_page_ == nullptr && request.num_pages_ == 1) {
+      std::vector<page_id_t> page_ids{request.page_id_};
+      while (page_ids.size() < PREFETCH_BATCH_PAGES && !prefetch_queue_.empty() &&
+             prefetch_queue_.front().next_page_ == nullptr && prefetch_queue_.front().num_pages_ == 1) {
+        page_ids.push_back(prefetch_queue_.front().page_id_);
+        prefetch_queue_.pop_front();
+      }
+      lock.unlock();
+      PrefetchBatchImpl(page_ids);
+      lock.lock();
+      continue;
+    }
+    lock.unlock();
+
+    page_id_t page_id = request.page_id_;
+    for (size_t i = 0; i < request.num_pages_ && page_id != INVALID_PAGE_ID; i++) {
+      if (!PrefetchPageImpl(page_id, request.next_page_, &page_id)) {
+        break;
+      }
+    }
+
+    lock.lock();
+  }
+}
+
+void BufferPoolManager::StopPrefetchThreads() {
+  {
+    std::scoped_lock lock{prefetch_latch_};
+    stop_prefetch_ = true;
+    prefetch_queue_.clear();
+    prefetch_cv_.notify_all();
+  }
+  for (auto &thread : prefetch_threads_) {
+    thread.join();
+  }
+  prefetch_threads_.clear();
+}
+
+void BufferPoolManager::RunPageCleaner() {
+  std::unique_lock lock{latch_};
+  while (true) {
+    page_cleaner_cv_.wait_for(lock, page_cleaner_interval, [this] { return stop_page_cleaner_; });
+    if (stop_page_cleaner_) {
+      return;
+    }
+    CleanPages(&lock);
+  }
+}
+
+void BufferPoolManager::CleanPages(std::unique_lock<std::mutex> *lock) {
+  size_t dirty_pages = 0;
+  for (size_t i = 0; i < pool_size_; i++) {
+    if (frames_[i]->is_dirty_ && frames_[i]->pin_count_ == 0) {
+      dirty_pages++;
+    }
+  }
+  size_t target = pool_size_ * page_cleaner_dirty_percent / 100;
+  if (dirty_pages <= target) {
+    return;
+  }
+  size_t max_pages = std::min<size_t>(dirty_pages - target, page_cleaner_max_pages);
+
+  // Every unpinned page is in the replacer, so its upcoming victims cover all candidates in the order they are going
+  // to be evicted. Replacers that cannot tell are cleaned in frame order.
+  std::vector<frame_id_t> frames;
+  replacer_->PeekVictims(pool_size_, &frames);
+  if (frames.empty()) {
+    for (size_t i = 0; i < pool_size_; i++) {
+      frames.push_back(static_cast<frame_id_t>(i));
+    }
+  }
+
+  // Write-ahead logging: a page may only reach the disk after the log records that changed it.
+  bool check_lsn = enable_logging && log_manager_ != nullptr;
+  lsn_t persistent_lsn = check_lsn ? log_manager_->GetPersistentLSN() : INVALID_LSN;
+  // The copies let the pages be modified, evicted or reused while they are written.
+  AlignedBuffer buffer = AlignedMemory::Allocate(max_pages * page_size_);
+  std::vector<std::pair<page_id_t, size_t>> batch;
+  for (frame_id_t frame_id : frames) {
+    if (batch.size() == max_pages) {
+      break;
+    }
+    Page *page = frames_[frame_id];
+    if (!page->is_dirty_ || page->pin_count_ > 0 || page->io_in_progress_ || page->page_id_ == INVALID_PAGE_ID) {
+      continue;
+    }
+    if (check_lsn && page->GetLSN() > persistent_lsn) {
+      continue;
+    }
+    memcpy(buffer.get() + batch.size() * page_size_, page->GetData(), page_size_);
+    page->is_dirty_ = false;
+    cleaning_pages_.insert(page->page_id_);
+    batch.emplace_back(page->page_id_, batch.size());
+  }
+  if (batch.empty()) {
+    return;
+  }
+  lock->unlock();
+
+  std::vector<std::pair<page_id_t, const char *>> pages;
+  pages.reserve(batch.size());
+  for (const auto &[page_id, index] : batch) {
+    pages.emplace_back(page_id, buffer.get() + index * page_size_);
+  }
+  WriteBatchToDisk(&pages);
+
+  lock->lock();
+  for (const auto &entry : batch) {
+    cleaning_pages_.erase(entry.first);
+  }
+  cleaning_cv_.notify_all();
+}
+
+void BufferPoolManager::StopPageCleaner() {
+  {
+    std::scoped_lock lock{latch_};
+    stop_page_cleaner_ = true;
+    page_cleaner_cv_.notify_all();
+  }
+  if (page_cleaner_.joinable()) {
+    page_cleaner_.join();
+  }
+}
+
+void BufferPoolManager::Resize(size_t new_size) {
+  std::scoped_lock resize_lock{resize_latch_};
+  std::unique_lock lock{latch_};
+  size_t old_size = pool_size_;
+  if (new_size >= old_size) {
+    if (new_size > frames_.size()) {
+      AllocateFrames(new_size - frames_.size());
+    }
+    for (size_t i = old_size; i < new_size; i++) {
+      free_list_.emplace_back(static_cast<frame_id_t>(i));
+    }
+    pool_size_ = new_size;
+    replacer_->Resize(new_size);
+    if (new_size > 0 && !page_cleaner_.joinable()) {
+      page_cleaner_ = std::thread(&BufferPoolManager::RunPageCleaner, this);
+    }
+    return;
+  }
+
+  // From here on the frames past new_size are no longer handed out, and unpinning them wakes us up.
+  pool_size_ = new_size;
+  free_list_.remove_if([new_size](frame_id_t frame_id) { return static_cast<size_t>(frame_id) >= new_size; });
+  while (true) {
+    bool done = true;
+    std::vector<frame_id_t> write_back;
+    for (size_t i = new_size; i < old_size; i++) {
+      Page *page = frames_[i];
+      if (page->page_id_ == INVALID_PAGE_ID && page->pin_count_ == 0) {
+        continue;
+      }
+      if (page->pin_count_ > 0 || page->io_in_progress_) {
+        done = false;
+        continue;
+      }
+      // Evict the page like a victim; a dirty page is written back without latch_, a clean one is gone right away.
+      replacer_->SetEvictable(static_cast<frame_id_t>(i), false);
+      page_table_.erase(page->page_id_);
+      CountEviction(page);
+      if (page->is_dirty_) {
+        done = false;
+        evicting_pages_[page->page_id_] = static_cast<frame_id_t>(i);
+        page->io_in_progress_ = true;
+        write_back.push_back(static_cast<frame_id_t>(i));
+      } else {
+        page->page_id_ = INVALID_PAGE_ID;
+      }
+    }
+    if (done) {
+      break;
+    }
+    if (write_back.empty()) {
+      resize_cv_.wait(lock);
+      continue;
+    }
+    for (frame_id_t frame_id : write_back) {
+      page_id_t page_id = frames_[frame_id]->page_id_;
+      cleaning_cv_.wait(lock, [this, page_id] { return cleaning_pages_.count(page_id) == 0; });
+    }
+    lock.unlock();
+    for (frame_id_t frame_id : write_back) {
+      WriteToDisk(frames_[frame_id]->page_id_, frames_[frame_id]->GetData());
+    }
+    lock.lock();
+    for (frame_id_t frame_id : write_back) {
+      Page *page = frames_[frame_id];
+      evicting_pages_.erase(page->page_id_);
+      page->page_id_ = INVALID_PAGE_ID;
+      page->is_dirty_ = false;
+      page->io_in_progress_ = false;
+      page->io_cv_.notify_all();
+    }
+  }
+
+  // Give back the memory of the chunks that only hold removed frames. The first chunk is kept.
+  while (page_chunks_.size() > 1 && page_chunks_.back().first_frame_ >= new_size) {
+    frames_.resize(page_chunks_.back().first_frame_);
+    page_chunks_.pop_back();
+  }
+  replacer_->Resize(new_size);
+}
+
+BufferPoolStats BufferPoolManager::GetStats() {
+  BufferPoolStats stats;
+  counters_.Snapshot(&stats);
+  std::scoped_lock lock{latch_};
+  for (Page *page : frames_) {
+    if (page->pin_count_ > 0) {
+      stats.pinned_frames_++;
+    }
+  }
+  return stats;
+}
+
+void BufferPoolManager::ResetStats() { counters_.Reset(); }
+
+void BufferPoolManager::StartTrace(const std::string &file_name) {
+  SetTrace(std::make_shared<PageTraceWriter>(file_name));
+}
+
+void BufferPoolManager::StopTrace() { SetTrace(nullptr); }
+
+void BufferPoolManager::SetTrace(std::shared_ptr<PageTraceWriter> trace) {
+  std::shared_ptr<PageTraceWriter> old_trace;
+  {
+    std::scoped_lock lock{latch_};
+    old_trace = std::move(trace_);
+    trace_ = std::move(trace);
+  }
+  // The old trace is flushed and closed without latch_, unless another instance still records into it.
+}
+
+void BufferPoolManager::ReadFromDisk(page_id_t page_id, char *data) {
+  auto start = std::chrono::steady_clock::now();
+  disk_manager_->ReadPage(page_id, data);
+  counters_.RecordRead(std::chrono::steady_clock::now() - start);
+}
+
+void BufferPoolManager::WriteToDisk(page_id_t page_id, const char *data) {
+  auto start = std::chrono::steady_clock::now();
+  disk_manager_->WritePage(page_id, data);
+  counters_.RecordWrite(std::chrono::steady_clock::now() - start);
+}
+
+void BufferPoolManager::WriteBatchToDisk(std::vector<std::pair<page_id_t, const char *>> *pages) {
+  if (pages->empty()) {
+    return;
+  }
+  auto start = std::chrono::steady_clock::now();
+  disk_manager_->WritePages(pages);
+  auto latency = (std::chrono::steady_clock::now() - start) / pages->size();
+  for (size_t i = 0; i < pages->size(); i++) {
+    counters_.RecordWrite(latency);
+  }
+}
+
+std::vector<bool> BufferPoolManager::ReadBatchFromDisk(const std::vector<std::pair<page_id_t, char *>> &pages) {
+  std::vector<bool> read(pages.size());
+  if (pages.empty()) {
+    return read;
+  }
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::future<bool>> reads;
+  reads.reserve(pages.size());
+  for (const auto &[page_id, data] : pages) {
+    reads.push_back(disk_manager_->ReadPageAsync(page_id, data));
+  }
+  for (size_t i = 0; i < reads.size(); i++) {
+    read[i] = reads[i].get();
+  }
+  auto latency = (std::chrono::steady_clock::now() - start) / pages.size();
+  for (size_t i = 0; i < pages.size(); i++) {
+    counters_.RecordRead(latency);
+  }
+  return read;
+}
+
+void BufferPoolManager::CountEviction(Page *page) {
+  BufferPoolCounters::Increment(page->is_dirty_ ? &counters_.dirty_evictions_ : &counters_.clean_evictions_);
+}
+
+void BufferPoolManager::AllocateFrames(size_t num_frames) {
+  PageChunk chunk{frames_.size(), std::make_unique<Page[]>(num_frames),
+                  AlignedMemory::Allocate(num_frames * page_size_)};
+  for (size_t i = 0; i < num_frames; i++) {
+    chunk.pages_[i].data_ = chunk.data_.get() + i * page_size_;
+    chunk.pages_[i].page_size_ = page_size_;
+    chunk.pages_[i].frame_id_ = static_cast<frame_id_t>(frames_.size());
+    frames_.push_back(&chunk.pages_[i]);
+  }
+  page_chunks_.push_back(std::move(chunk));
+}
+
+void BufferPoolManager::UnpinFrame(frame_id_t frame_id) {
+  Page *page = frames_[frame_id];
+  if (--page->pin_count_ > 0) {
+    return;
+  }
+  // The frame of a page that could not be read in is free once its last waiter let go of it.
+  if (page->page_id_ == INVALID_PAGE_ID) {
+    ReleaseFrame(frame_id);
+    return;
+  }
+  // Unlike DeletePage, this cannot wait for a copy the page cleaner may be writing; new pages wait for it instead.
+  if (page->delete_pending_) {
+    page_id_t page_id = page->page_id_;
+    page->delete_pending_ = false;
+    DropFrame(page);
+    ReleaseFrame(frame_id);
+    disk_manager_->DeallocatePage(page_id);
+    return;
+  }
+  if (static_cast<size_t>(frame_id) < pool_size_) {
+    replacer_->Unpin(frame_id);
+  } else {
+    resize_cv_.notify_all();
+  }
+}
+
+void BufferPoolManager::ReleaseFrame(frame_id_t frame_id) {
+  if (static_cast<size_t>(frame_id) < pool_size_) {
+    free_list_.push_back(frame_id);
+  } else {
+    resize_cv_.notify_all();
+  }
+}
+
+bool BufferPoolManager::FindFreeFrame(frame_id_t *frame_id, page_id_t *victim_page_id) {
+  *victim_page_id = INVALID_PAGE_ID;
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    return true;
+  }
+  if (!replacer_->Victim(frame_id)) {
+    return false;
+  }
+  Page *victim = frames_[*frame_id];
+  page_table_.erase(victim->GetPageId());
+  CountEviction(victim);
+  if (victim->IsDirty()) {
+    *victim_page_id = victim->GetPageId();
+    evicting_pages_[*victim_page_id] = *frame_id;
+  }
+  return true;
+}
+
+bool BufferPoolManager::FindRingFrame(BufferRing *ring, frame_id_t *frame_id, page_id_t *victim_page_id) {
+  auto &frames = ring->rings_[this];
+  if (frames.slots_.size() < ring->ring_size_) {
+    return false;
+  }
+  const auto &slot = frames.slots_[frames.next_];
+  // The frame may have been removed by a Resize since the ring recorded it.
+  if (static_cast<size_t>(slot.frame_id_) >= pool_size_) {
+    return false;
+  }
+  Page *page = frames_[slot.frame_id_];
+  if (page->page_id_ != slot.page_id_ || page->pin_count_ > 0) {
+    return false;
+  }
+  // Take the frame out of the replacer; from here on it is handled exactly like a victim.
+  replacer_->SetEvictable(slot.frame_id_, false);
+  page_table_.erase(slot.page_id_);
+  CountEviction(page);
+  *frame_id = slot.frame_id_;
+  *victim_page_id = INVALID_PAGE_ID;
+  if (page->is_dirty_) {
+    *victim_page_id = slot.page_id_;
+    evicting_pages_[slot.page_id_] = slot.frame_id_;
+  }
+  return true;
+}
+
+void BufferPoolManager::RecordRingFrame(BufferRing *ring, frame_id_t frame_id, page_id_t page_id) {
+  auto &frames = ring->rings_[this];
+  if (frames.slots_.size() < ring->ring_size_) {
+    frames.slots_.push_back({frame_id, page_id});
+    return;
+  }
+  // Only pages the scan found read ahead get here with the replaced slot still intact. Handing that frame back keeps
+  // the scan from spreading over the whole pool through read-ahead.
+  const auto &slot = frames.slots_[frames.next_];
+  if (slot.frame_id_ != frame_id && static_cast<size_t>(slot.frame_id_) < pool_size_) {
+    Page *replaced = frames_[slot.frame_id_];
+    if (replaced->page_id_ == slot.page_id_ && replaced->pin_count_ == 0 && !replaced->is_dirty_ &&
+        !replaced->io_in_progress_) {
+      replacer_->SetEvictable(slot.frame_id_, false);
+      page_table_.erase(slot.page_id_);
+      CountEviction(replaced);
+      replaced->page_id_ = INVALID_PAGE_ID;
+      replaced->prefetched_ = false;
+      free_list_.push_back(slot.frame_id_);
+    }
+  }
+  frames.slots_[frames.next_] = {frame_id, page_id};
+  frames.next_ = (frames.next_ + 1) % ring->ring_size_;
+}
+
+bool BufferPoolManager::FindQuotaOrFreeFrame(BufferQuota *quota, frame_id_t *frame_id, page_id_t *victim_page_id) {
+  return (quota != nullptr && FindQuotaFrame(quota, frame_id, victim_page_id)) ||
+         FindFreeFrame(frame_id, victim_page_id);
+}
+
+bool BufferPoolManager::FindQuotaFrame(BufferQuota *quota, frame_id_t *frame_id, page_id_t *victim_page_id) {
+  auto &frames = quota->frames_[this];
+  auto iter = frames.slots_.begin();
+  while (frames.slots_.size() >= quota->quota_pages_ && iter != frames.slots_.end()) {
+    Page *page = static_cast<size_t>(iter->frame_id_) < pool_size_ ? frames_[iter->frame_id_] : nullptr;
+    // The page was evicted by the replacer, deleted or its frame removed by a Resize: the frame is no longer ours.
+    if (page == nullptr || page->page_id_ != iter->page_id_) {
+      frames.index_.erase(iter->frame_id_);
+      iter = frames.slots_.erase(iter);
+      continue;
+    }
+    if (page->pin_count_ > 0 || page->io_in_progress_) {
+      ++iter;
+      continue;
+    }
+    // Take the frame out of the replacer; from here on it is handled exactly like a victim.
+    replacer_->SetEvictable(iter->frame_id_, false);
+    page_table_.erase(iter->page_id_);
+    CountEviction(page);
+    *frame_id = iter->frame_id_;
+    *victim_page_id = INVALID_PAGE_ID;
+    if (page->is_dirty_) {
+      *victim_page_id = iter->page_id_;
+      evicting_pages_[iter->page_id_] = iter->frame_id_;
+    }
+    frames.index_.erase(iter->frame_id_);
+    frames.slots_.erase(iter);
+    return true;
+  }
+  return false;
+}
+
+void BufferPoolManager::RecordQuotaFrame(BufferQuota *quota, frame_id_t frame_id, page_id_t page_id) {
+  auto &frames = quota->frames_[this];
+  auto iter = frames.index_.find(frame_id);
+  if (iter != frames.index_.end()) {
+    frames.slots_.erase(iter->second);
+  }
+  frames.index_[frame_id] = frames.slots_.insert(frames.slots_.end(), {frame_id, page_id});
+}
+
+void BufferPoolManager::TouchQuotaFrame(BufferQuota *quota, frame_id_t frame_id, page_id_t page_id) {
+  auto &frames = quota->frames_[this];
+  auto iter = frames.index_.find(frame_id);
+  if (iter != frames.index_.end() && iter->second->page_id_ == page_id) {
+    frames.slots_.splice(frames.slots_.end(), frames.slots_, iter->second);
+  }
+}
+
+Page *BufferPoolManager::InstallNewPage(frame_id_t frame_id, page_id_t page_id) {
+  Page *page = frames_[frame_id];
+  page_table_[page_id] = frame_id;
+  page->page_id_ = page_id;
+  page->pin_count_ = 1;
+  page->is_dirty_ = false;
+  page->io_in_progress_ = true;
+  page->delete_pending_ = false;
+  page->prefetched_ = false;
+  replacer_->RecordPage(frame_id, page_id);
+  replacer_->SetEvictable(frame_id, false);
+  return page;
+}
+
+void BufferPoolManager::LoadFrame(std::unique_lock<std::mutex> *lock, Page *page, page_id_t victim_page_id,
+                                  bool read_from_disk) {
+  page_id_t page_id = page->page_id_;
+  if (victim_page_id != INVALID_PAGE_ID) {
+    // The victim was dirtied again after the page cleaner copied it; that copy must land first.
+    cleaning_cv_.wait(*lock, [this, victim_page_id] { return cleaning_pages_.count(victim_page_id) == 0; });
+  }
+  lock->unlock();
+
+  if (victim_page_id != INVALID_PAGE_ID) {
+    WriteToDisk(victim_page_id, page->GetData());
+  }
+  std::exception_ptr failure;
+  if (read_from_disk) {
+    try {
+      ReadFromDisk(page_id, page->GetData());
+    } catch (const Exception &) {
+      failure = std::current_exception();
+    }
+  } else {
+    page->ResetMemory();
+  }
+
+  lock->lock();
+  if (victim_page_id != INVALID_PAGE_ID) {
+    evicting_pages_.erase(victim_page_id);
+  }
+  if (failure) {
+    DropFrame(page);
+  }
+  page->io_in_progress_ = false;
+  page->io_cv_.notify_all();
+  if (failure) {
+    UnpinFrame(page->frame_id_);
+    std::rethrow_exception(failure);
+  }
+}
+
+void BufferPoolManager::WaitForPageWrites(std::unique_lock<std::mutex> *lock, page_id_t page_id) {
+  while (true) {
+    auto evicting = evicting_pages_.find(page_id);
+    if (evicting != evicting_pages_.end()) {
+      Page *frame = frames_[evicting->second];
+      frame->io_cv_.wait(*lock, [this, page_id] { return evicting_pages_.count(page_id) == 0; });
+      continue;
+    }
+    if (cleaning_pages_.count(page_id) == 0) {
+      return;
+    }
+    cleaning_cv_.wait(*lock, [this, page_id] { return cleaning_pages_.count(page_id) == 0; });
+  }
+}
+
+Page *BufferPoolManager::TakeOverStaleCopy(std::unique_lock<std::mutex> *lock, page_id_t page_id,
+                                           BufferQuota *quota) {
+  while (true) {
+    auto iter = page_table_.find(page_id);
+    if (iter == page_table_.end()) {
+      return nullptr;
+    }
+    frame_id_t frame_id = iter->second;
+    Page *page = frames_[frame_id];
+    page->pin_count_++;
+    replacer_->Pin(frame_id);
+    page->io_cv_.wait(*lock, [page] { return !page->io_in_progress_; });
+    // The read of the stale copy failed and the frame was given up.
+    if (page->page_id_ != page_id) {
+      UnpinFrame(frame_id);
+      continue;
+    }
+    TracePageAccess(page_id, PageAccessType::NEW);
+    if (quota != nullptr) {
+      TouchQuotaFrame(quota, frame_id, page_id);
+    }
+    page->is_dirty_ = false;
+    page->delete_pending_ = false;
+    page->prefetched_ = false;
+    page->ResetMemory();
+    return page;
+  }
+}
+
+void BufferPoolManager::DropFrame(Page *page) {
+  page_table_.erase(page->page_id_);
+  page->page_id_ = INVALID_PAGE_ID;
+  page->is_dirty_ = false;
+  page->ResetMemory();
 }
 
 }  // namespace bustub
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.cpp
+//
+// Identification: src/buffer/buffer_pool_stats.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_stats.h"
+
+#include <numeric>
+#include <sstream>
+
+namespace bustub {
+
+double BufferPoolStats::HitRate() const {
+  uint64_t fetches = hits_ + misses_;
+  return fetches == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(fetches);
+}
+
+uint64_t BufferPoolStats::Reads() const {
+  return std::accumulate(read_latency_.begin(), read_latency_.end(), static_cast<uint64_t>(0));
+}
+
+uint64_t BufferPoolStats::Writes() const {
+  return std::accumulate(write_latency_.begin(), write_latency_.end(), static_cast<uint64_t>(0));
+}
+
+uint64_t BufferPoolStats::Percentile(const LatencyHistogram &histogram, double fraction) {
+  uint64_t total = std::accumulate(histogram.begin(), histogram.end(), static_cast<uint64_t>(0));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+    seen += histogram[i];
+    if (seen > 0 && static_cast<double>(seen) >= fraction * static_cast<double>(total)) {
+      return static_cast<uint64_t>(1) << i;
+    }
+  }
+  return 0;
+}
+
+BufferPoolStats &BufferPoolStats::operator+=(const BufferPoolStats &other) {
+  hits_ += other.hits_;
+  misses_ += other.misses_;
+  clean_evictions_ += other.clean_evictions_;
+  dirty_evictions_ += other.dirty_evictions_;
+  pin_waits_ += other.pin_waits_;
+  pinned_frames_ += other.pinned_frames_;
+  for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+    read_latency_[i] += other.read_latency_[i];
+    write_latency_[i] += other.write_latency_[i];
+  }
+  return *this;
+}
+
+std::string BufferPoolStats::ToString() const {
+  std::ostringstream os;
+  os << "hits=" << hits_ << " misses=" << misses_ << " hit_rate=" << HitRate()
+     << " clean_evictions=" << clean_evictions_ << " dirty_evictions=" << dirty_evictions_
+     << " pin_waits=" << pin_waits_ << " pinned_frames=" << pinned_frames_ << " reads=" << Reads()
+     << " read_p50_us=" << Percentile(read_latency_, 0.5) << " read_p99_us=" << Percentile(read_latency_, 0.99)
+     << " writes=" << Writes() << " write_p50_us=" << Percentile(write_latency_, 0.5)
+     << " write_p99_us=" << Percentile(write_latency_, 0.99);
+  return os.str();
+}
+
+void BufferPoolCounters::Snapshot(BufferPoolStats *stats) const {
+  stats->hits_ = hits_.load(std::memory_order_relaxed);
+  stats->misses_ = misses_.load(std::memory_order_relaxed);
+  stats->clean_evictions_ = clean_evictions_.load(std::memory_order_relaxed);
+  stats->dirty_evictions_ = dirty_evictions_.load(std::memory_order_relaxed);
+  stats->pin_waits_ = pin_waits_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+    stats->read_latency_[i] = read_latency_[i].load(std::memory_order_relaxed);
+    stats->write_latency_[i] = write_latency_[i].load(std::memory_order_relaxed);
+  }
+}
+
+void BufferPoolCounters::Reset() {
+  for (auto *counter : {&hits_, &misses_, &clean_evictions_, &dirty_evictions_, &pin_waits_}) {
+    counter->store(0, std::memory_order_relaxed);
+  }
+  for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+    read_latency_[i].store(0, std::memory_order_relaxed);
+    write_latency_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void BufferPoolCounters::Record(AtomicHistogram *histogram, std::chrono::nanoseconds latency) {
+  auto micros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+  size_t bucket = 0;
+  while (micros > 0 && bucket < LATENCY_BUCKETS - 1) {
+    micros >>= 1;
+    bucket++;
+  }
+  (*histogram)[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace bustub
@@ -0,0 +1,19 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_quota.cpp
+//
+// Identification: src/buffer/buffer_quota.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_quota.h"
+
+namespace bustub {
+
+thread_local BufferQuota *BufferQuota::current_ = nullptr;
+
+}  // namespace bustub
@@ -14,16 +14,75 @@
 
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages) : in_replacer_(num_pages, false), ref_bits_(num_pages, false) {}
 
 ClockReplacer::~ClockReplacer() = default;
 
-bool ClockReplacer::Victim(frame_id_t *frame_id) { return false; }
+bool ClockReplacer::Victim(frame_id_t *frame_id) {
+  std::scoped_lock lock{latch_};
+  if (size_ == 0) {
+    return false;
+  }
+  // Every frame in the replacer has its reference bit cleared within one sweep, so this ends within two.
+  while (true) {
+    size_t frame = clock_hand_;
+    clock_hand_ = (clock_hand_ + 1) % in_replacer_.size();
+    if (!in_replacer_[frame]) {
+      continue;
+    }
+    if (ref_bits_[frame]) {
+      ref_bits_[frame] = false;
+      continue;
+    }
+    in_replacer_[frame] = false;
+    size_--;
+    *frame_id = static_cast<frame_id_t>(frame);
+    return true;
+  }
+}
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+void ClockReplacer::Pin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  if (in_replacer_[frame_id]) {
+    in_replacer_[frame_id] = false;
+    size_--;
+  }
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+void ClockReplacer::Unpin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  if (!in_replacer_[frame_id]) {
+    in_replacer_[frame_id] = true;
+    size_++;
+  }
+  ref_bits_[frame_id] = true;
+}
 
-size_t ClockReplacer::Size() { return 0; }
+size_t ClockReplacer::Size() {
+  std::scoped_lock lock{latch_};
+  return size_;
+}
+
+void ClockReplacer::PeekVictims(size_t max_frames, std::vector<frame_id_t> *frames) {
+  std::scoped_lock lock{latch_};
+  // The hand takes the frames without a reference bit during its first sweep and the others during its second.
+  for (bool referenced : {false, true}) {
+    for (size_t i = 0; i < in_replacer_.size() && frames->size() < max_frames; i++) {
+      size_t frame = (clock_hand_ + i) % in_replacer_.size();
+      if (in_replacer_[frame] && ref_bits_[frame] == referenced) {
+        frames->push_back(static_cast<frame_id_t>(frame));
+      }
+    }
+  }
+}
+
+void ClockReplacer::Resize(size_t num_pages) {
+  std::scoped_lock lock{latch_};
+  in_replacer_.resize(num_pages, false);
+  ref_bits_.resize(num_pages, false);
+  if (clock_hand_ >= num_pages) {
+    clock_hand_ = 0;
+  }
+}
 
 }  // namespace bustub
@@ -0,0 +1,182 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.cpp
+//
+// Identification: src/buffer/lru_k_replacer.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/lru_k_replacer.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k, size_t correlated_reference_period)
+    : k_(k), correlated_reference_period_(correlated_reference_period) {
+  BUSTUB_ASSERT(k_ > 0, "LRU-K needs to track at least one reference.");
+  frames_.reserve(num_pages);
+}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  std::scoped_lock lock{latch_};
+  if (evictable_count_ == 0) {
+    return false;
+  }
+
+  bool found = false;
+  EvictionKey best_key{};
+  for (const auto &[id, frame] : frames_) {
+    if (!frame.evictable_) {
+      continue;
+    }
+    EvictionKey key = GetEvictionKey(frame);
+    if (!found || key < best_key) {
+      found = true;
+      best_key = key;
+      *frame_id = id;
+    }
+  }
+
+  frames_.erase(*frame_id);
+  evictable_count_--;
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  size_t now = ++current_time_;
+  auto iter = frames_.find(frame_id);
+  if (iter == frames_.end()) {
+    FrameHistory &frame = frames_[frame_id];
+    frame.history_.push_front(now);
+    frame.last_ = now;
+    return;
+  }
+
+  FrameHistory &frame = iter->second;
+  if (frame.evictable_) {
+    frame.evictable_ = false;
+    evictable_count_--;
+  }
+  if (frame.history_.empty()) {
+    frame.history_.push_front(now);
+  } else if (!IsCorrelated(frame, now)) {
+    // A new, uncorrelated reference. The previous correlated burst is treated as a single reference at its start, so
+    // older history is shifted forward by the length of that burst.
+    size_t correlated_span = frame.last_ - frame.history_.front();
+    for (auto &time : frame.history_) {
+      time += correlated_span;
+    }
+    frame.history_.push_front(now);
+    if (frame.history_.size() > k_) {
+      frame.history_.pop_back();
+    }
+  }
+  frame.last_ = now;
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  auto iter = frames_.find(frame_id);
+  if (iter == frames_.end()) {
+    // Never referenced through Pin: it enters with a single reference now.
+    FrameHistory &frame = frames_[frame_id];
+    frame.history_.push_front(++current_time_);
+    frame.last_ = current_time_;
+    frame.evictable_ = true;
+    evictable_count_++;
+    return;
+  }
+  if (!iter->second.evictable_) {
+    iter->second.evictable_ = true;
+    evictable_count_++;
+  }
+}
+
+void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool evictable) {
+  std::scoped_lock lock{latch_};
+  auto [iter, inserted] = frames_.try_emplace(frame_id);
+  FrameHistory &frame = iter->second;
+  if (inserted) {
+    frame.last_ = current_time_;
+  }
+  if (frame.evictable_ != evictable) {
+    frame.evictable_ = evictable;
+    if (evictable) {
+      evictable_count_++;
+    } else {
+      evictable_count_--;
+    }
+  }
+}
+
+size_t LRUKReplacer::Size() {
+  std::scoped_lock lock{latch_};
+  return evictable_count_;
+}
+
+void LRUKReplacer::PeekVictims(size_t max_frames, std::vector<frame_id_t> *frames) {
+  std::scoped_lock lock{latch_};
+  std::vector<std::pair<EvictionKey, frame_id_t>> candidates;
+  candidates.reserve(evictable_count_);
+  for (const auto &[id, frame] : frames_) {
+    if (frame.evictable_) {
+      candidates.emplace_back(GetEvictionKey(frame), id);
+    }
+  }
+  size_t count = std::min(max_frames, candidates.size());
+  std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+  for (size_t i = 0; i < count; i++) {
+    frames->push_back(candidates[i].second);
+  }
+}
+
+LRUKReplacer::EvictionKey LRUKReplacer::GetEvictionKey(const FrameHistory &frame) const {
+  // Candidates outside their correlated reference period are preferred over those inside it. Among either group, an
+  // infinite backward K-distance beats a finite one, and ties are broken by the oldest recorded reference. For an
+  // infinite distance that is plain LRU on the oldest known reference. A frame that was never referenced counts from
+  // its load and is never correlated.
+  if (frame.history_.empty()) {
+    return {false, false, frame.last_};
+  }
+  bool correlated = IsCorrelated(frame, current_time_);
+  bool finite = frame.history_.size() >= k_;
+  return {correlated, finite, frame.history_.back()};
+}
+
+void LRUKReplacer::Resize(size_t num_pages) {
+  std::scoped_lock lock{latch_};
+  // Frames past the new size are pinned and never come back under their old page, so their history goes.
+  for (auto iter = frames_.begin(); iter != frames_.end();) {
+    if (static_cast<size_t>(iter->first) >= num_pages) {
+      iter = frames_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+}
+
+void LRUKReplacer::RecordPage(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock lock{latch_};
+  auto iter = frames_.find(frame_id);
+  if (iter == frames_.end()) {
+    return;
+  }
+  if (iter->second.evictable_) {
+    evictable_count_--;
+  }
+  frames_.erase(iter);
+}
+
+}  // namespace bustub
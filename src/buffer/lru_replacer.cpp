@@ -14,16 +14,51 @@
 
 namespace bustub {
 
-LRUReplacer::LRUReplacer(size_t num_pages) {}
+LRUReplacer::LRUReplacer(size_t num_pages) { lru_map_.reserve(num_pages); }
 
 LRUReplacer::~LRUReplacer() = default;
 
-bool LRUReplacer::Victim(frame_id_t *frame_id) { return false; }
+bool LRUReplacer::Victim(frame_id_t *frame_id) {
+  std::scoped_lock lock{latch_};
+  if (lru_list_.empty()) {
+    return false;
+  }
+  *frame_id = lru_list_.back();
+  lru_map_.erase(*frame_id);
+  lru_list_.pop_back();
+  return true;
+}
 
-void LRUReplacer::Pin(frame_id_t frame_id) {}
+void LRUReplacer::Pin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  auto iter = lru_map_.find(frame_id);
+  if (iter == lru_map_.end()) {
+    return;
+  }
+  lru_list_.erase(iter->second);
+  lru_map_.erase(iter);
+}
 
-void LRUReplacer::Unpin(frame_id_t frame_id) {}
+void LRUReplacer::Unpin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  // A frame that is already evictable keeps its position.
+  if (lru_map_.count(frame_id) != 0) {
+    return;
+  }
+  lru_list_.push_front(frame_id);
+  lru_map_[frame_id] = lru_list_.begin();
+}
 
-size_t LRUReplacer::Size() { return 0; }
+size_t LRUReplacer::Size() {
+  std::scoped_lock lock{latch_};
+  return lru_list_.size();
+}
+
+void LRUReplacer::PeekVictims(size_t max_frames, std::vector<frame_id_t> *frames) {
+  std::scoped_lock lock{latch_};
+  for (auto iter = lru_list_.rbegin(); iter != lru_list_.rend() && frames->size() < max_frames; ++iter) {
+    frames->push_back(*iter);
+  }
+}
 
 }  // namespace bustub
@@ -0,0 +1,195 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_trace.cpp
+//
+// Identification: src/buffer/page_trace.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <random>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+static constexpr char TRACE_MAGIC[] = "BTTRACE1";
+static constexpr size_t TRACE_MAGIC_SIZE = sizeof(TRACE_MAGIC) - 1;
+/** Size of the buffer of a trace writer at which it writes to the file. */
+static constexpr size_t TRACE_BUFFER_SIZE = 1 << 16;
+
+PageTraceWriter::PageTraceWriter(const std::string &file_name)
+    : out_(file_name, std::ios::binary | std::ios::out | std::ios::trunc) {
+  if (!out_.is_open()) {
+    throw Exception("can't open trace file " + file_name);
+  }
+  out_.write(TRACE_MAGIC, TRACE_MAGIC_SIZE);
+  buffer_.reserve(TRACE_BUFFER_SIZE + 8);
+  writer_ = std::thread(&PageTraceWriter::RunWriter, this);
+}
+
+PageTraceWriter::~PageTraceWriter() {
+  Flush();
+  {
+    std::scoped_lock lock{latch_};
+    stop_ = true;
+    full_cv_.notify_one();
+  }
+  writer_.join();
+}
+
+void PageTraceWriter::Record(page_id_t page_id, PageAccessType type) {
+  std::scoped_lock lock{latch_};
+  auto delta = static_cast<int64_t>(page_id) - last_page_id_;
+  auto zigzag = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+  uint64_t value = (zigzag << 1) | static_cast<uint64_t>(type);
+  while (value >= 0x80) {
+    buffer_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  buffer_.push_back(static_cast<char>(value));
+  last_page_id_ = page_id;
+  num_records_++;
+  // The buffer pool records accesses under its latch, so the file is left to the writer thread.
+  if (buffer_.size() >= TRACE_BUFFER_SIZE) {
+    HandOffBuffer();
+  }
+}
+
+void PageTraceWriter::Flush() {
+  std::unique_lock lock{latch_};
+  if (!buffer_.empty()) {
+    HandOffBuffer();
+  }
+  written_cv_.wait(lock, [this] { return full_buffers_.empty() && !writing_; });
+  out_.flush();
+}
+
+size_t PageTraceWriter::GetNumRecords() {
+  std::scoped_lock lock{latch_};
+  return num_records_;
+}
+
+void PageTraceWriter::HandOffBuffer() {
+  full_buffers_.push_back(std::move(buffer_));
+  buffer_.clear();
+  buffer_.reserve(TRACE_BUFFER_SIZE + 8);
+  full_cv_.notify_one();
+}
+
+void PageTraceWriter::RunWriter() {
+  std::unique_lock lock{latch_};
+  while (true) {
+    full_cv_.wait(lock, [this] { return stop_ || !full_buffers_.empty(); });
+    if (full_buffers_.empty()) {
+      return;
+    }
+    std::string buffer = std::move(full_buffers_.front());
+    full_buffers_.pop_front();
+    writing_ = true;
+    lock.unlock();
+    out_.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    lock.lock();
+    writing_ = false;
+    written_cv_.notify_all();
+  }
+}
+
+PageTraceReader::PageTraceReader(const std::string &file_name) : in_(file_name, std::ios::binary | std::ios::in) {
+  char magic[TRACE_MAGIC_SIZE];
+  if (!in_.is_open() || !in_.read(magic, TRACE_MAGIC_SIZE) || memcmp(magic, TRACE_MAGIC, TRACE_MAGIC_SIZE) != 0) {
+    throw Exception("not a page trace: " + file_name);
+  }
+}
+
+bool PageTraceReader::Next(PageAccess *access) {
+  uint64_t value = 0;
+  int shift = 0;
+  int byte;
+  do {
+    byte = in_.get();
+    if (byte == std::char_traits<char>::eof()) {
+      return false;
+    }
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    shift += 7;
+  } while ((byte & 0x80) != 0);
+  uint64_t zigzag = value >> 1;
+  auto delta = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+  last_page_id_ = static_cast<page_id_t>(last_page_id_ + delta);
+  access->page_id_ = last_page_id_;
+  access->type_ = static_cast<PageAccessType>(value & 1);
+  return true;
+}
+
+std::vector<PageAccess> PageTraceReader::ReadAll(const std::string &file_name) {
+  PageTraceReader reader(file_name);
+  std::vector<PageAccess> accesses;
+  PageAccess access;
+  while (reader.Next(&access)) {
+    accesses.push_back(access);
+  }
+  return accesses;
+}
+
+std::vector<PageAccess> PageTraceGenerator::Zipfian(size_t num_pages, size_t num_accesses, double theta,
+                                                    uint64_t seed) {
+  std::mt19937_64 random(seed);
+  std::vector<double> cdf(num_pages);
+  double sum = 0;
+  for (size_t i = 0; i < num_pages; i++) {
+    sum += 1.0 / std::pow(static_cast<double>(i + 1), theta);
+    cdf[i] = sum;
+  }
+  // The rank of a page is not its page id, or the hot pages would all be neighbours.
+  std::vector<page_id_t> page_ids(num_pages);
+  std::iota(page_ids.begin(), page_ids.end(), 0);
+  std::shuffle(page_ids.begin(), page_ids.end(), random);
+
+  std::uniform_real_distribution<double> uniform(0, sum);
+  std::vector<PageAccess> accesses;
+  accesses.reserve(num_accesses);
+  for (size_t i = 0; i < num_accesses; i++) {
+    size_t rank = std::lower_bound(cdf.begin(), cdf.end(), uniform(random)) - cdf.begin();
+    accesses.push_back({page_ids[std::min(rank, num_pages - 1)], PageAccessType::FETCH});
+  }
+  return accesses;
+}
+
+std::vector<PageAccess> PageTraceGenerator::Scan(size_t hot_pages, size_t scan_length, size_t scan_interval,
+                                                 size_t num_accesses, uint64_t seed) {
+  std::mt19937_64 random(seed);
+  std::uniform_int_distribution<page_id_t> hot(0, static_cast<page_id_t>(hot_pages) - 1);
+  auto next_scan_page = static_cast<page_id_t>(hot_pages);
+  std::vector<PageAccess> accesses;
+  accesses.reserve(num_accesses);
+  while (accesses.size() < num_accesses) {
+    for (size_t i = 0; i < scan_interval && accesses.size() < num_accesses; i++) {
+      accesses.push_back({hot(random), PageAccessType::FETCH});
+    }
+    for (size_t i = 0; i < scan_length && accesses.size() < num_accesses; i++) {
+      accesses.push_back({next_scan_page++, PageAccessType::FETCH});
+    }
+  }
+  return accesses;
+}
+
+std::vector<PageAccess> PageTraceGenerator::Loop(size_t num_pages, size_t num_accesses) {
+  std::vector<PageAccess> accesses;
+  accesses.reserve(num_accesses);
+  for (size_t i = 0; i < num_accesses; i++) {
+    accesses.push_back({static_cast<page_id_t>(i % num_pages), PageAccessType::FETCH});
+  }
+  return accesses;
+}
+
+}  // namespace bustub
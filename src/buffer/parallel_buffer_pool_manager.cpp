@@ -0,0 +1,151 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size,
+                                                     DiskManager *disk_manager, LogManager *log_manager)
+    : BufferPoolManager(0, disk_manager, log_manager), num_instances_(num_instances) {
+  BUSTUB_ASSERT(num_instances_ > 0, "A parallel buffer pool needs at least one instance.");
+  instances_.reserve(num_instances_);
+  for (size_t i = 0; i < num_instances_; i++) {
+    instances_.push_back(new BufferPoolManager(pool_size, disk_manager, log_manager));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  // The prefetch threads call into the instances, so they have to be gone first.
+  StopPrefetchThreads();
+  for (auto *instance : instances_) {
+    delete instance;
+  }
+}
+
+size_t ParallelBufferPoolManager::GetPoolSize() {
+  size_t pool_size = 0;
+  for (auto *instance : instances_) {
+    pool_size += instance->GetPoolSize();
+  }
+  return pool_size;
+}
+
+void ParallelBufferPoolManager::Resize(size_t new_size) {
+  for (size_t i = 0; i < num_instances_; i++) {
+    instances_[i]->Resize(new_size / num_instances_ + (i < new_size % num_instances_ ? 1 : 0));
+  }
+}
+
+BufferPoolStats ParallelBufferPoolManager::GetStats() {
+  BufferPoolStats stats;
+  for (auto *instance : instances_) {
+    stats += instance->GetStats();
+  }
+  return stats;
+}
+
+void ParallelBufferPoolManager::ResetStats() {
+  for (auto *instance : instances_) {
+    instance->ResetStats();
+  }
+}
+
+void ParallelBufferPoolManager::StartTrace(const std::string &file_name) {
+  auto trace = std::make_shared<PageTraceWriter>(file_name);
+  for (auto *instance : instances_) {
+    instance->SetTrace(trace);
+  }
+}
+
+void ParallelBufferPoolManager::StopTrace() {
+  for (auto *instance : instances_) {
+    instance->SetTrace(nullptr);
+  }
+}
+
+Page *ParallelBufferPoolManager::FetchPageImpl(page_id_t page_id, BufferRing *ring, bool reference) {
+  BufferPoolManager *instance = GetInstance(page_id);
+  return reference ? instance->FetchPage(page_id, ring) : instance->FetchPageAgain(page_id, ring);
+}
+
+bool ParallelBufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
+  return GetInstance(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+Page *ParallelBufferPoolManager::FetchChildPageImpl(Page *parent, int slot, page_id_t child_id) {
+  // The swizzled pointer is a frame of the child's instance; the parent may live in another one.
+  return GetInstance(child_id)->FetchChildPage(parent, slot, child_id);
+}
+
+bool ParallelBufferPoolManager::UnpinPageImpl(Page *page, bool is_dirty) {
+  return GetInstance(page->GetPageId())->UnpinPage(page, is_dirty);
+}
+
+bool ParallelBufferPoolManager::FlushPageImpl(page_id_t page_id) {
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  return GetInstance(page_id)->FlushPage(page_id);
+}
+
+Page *ParallelBufferPoolManager::NewPageImpl(page_id_t *page_id) {
+  // Each instance is tried once, starting with the one after where the last call started, with an id it owns.
+  size_t start = next_instance_.fetch_add(1) % num_instances_;
+  for (size_t i = 0; i < num_instances_; i++) {
+    size_t index = (start + i) % num_instances_;
+    page_id_t candidate = disk_manager_->AllocatePage(num_instances_, index);
+    Page *page = instances_[index]->NewPageWithIdImpl(candidate);
+    if (page != nullptr) {
+      *page_id = candidate;
+      return page;
+    }
+    disk_manager_->DeallocatePage(candidate);
+  }
+  return nullptr;
+}
+
+bool ParallelBufferPoolManager::DeletePageImpl(page_id_t page_id) { return GetInstance(page_id)->DeletePage(page_id); }
+
+void ParallelBufferPoolManager::DeletePageWhenUnpinnedImpl(page_id_t page_id) {
+  GetInstance(page_id)->DeletePageWhenUnpinned(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPagesImpl() {
+  // The instances share the file, so one sync covers them all.
+  for (auto *instance : instances_) {
+    instance->FlushDirtyPages();
+  }
+  disk_manager_->SyncPages();
+}
+
+bool ParallelBufferPoolManager::PrefetchPageImpl(page_id_t page_id, page_link_fn next_page, page_id_t *next_page_id) {
+  return GetInstance(page_id)->PrefetchPageImpl(page_id, next_page, next_page_id);
+}
+
+void ParallelBufferPoolManager::PrefetchBatchImpl(const std::vector<page_id_t> &page_ids) {
+  std::vector<std::vector<page_id_t>> instance_page_ids(num_instances_);
+  for (page_id_t page_id : page_ids) {
+    instance_page_ids[static_cast<size_t>(page_id) % num_instances_].push_back(page_id);
+  }
+  for (size_t i = 0; i < num_instances_; i++) {
+    if (!instance_page_ids[i].empty()) {
+      instances_[i]->PrefetchBatchImpl(instance_page_ids[i]);
+    }
+  }
+}
+
+}  // namespace bustub
@@ -16,8 +16,22 @@ namespace bustub {
 
 std::atomic<bool> enable_logging(false);
 
+std::atomic<bool> enable_page_checksums(false);
+
 std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
+std::chrono::microseconds log_group_commit_window = std::chrono::microseconds(0);
+
+std::atomic<size_t> log_group_commit_bytes(LOG_BUFFER_SIZE / 2);
+
+std::atomic<size_t> log_segment_size(16 << 20);
+
+std::chrono::milliseconds page_cleaner_interval = std::chrono::milliseconds(50);
+
+std::atomic<size_t> page_cleaner_max_pages(32);
+
+std::atomic<size_t> page_cleaner_dirty_percent(25);
+
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
 }  // namespace bustub
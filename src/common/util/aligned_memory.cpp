@@ -0,0 +1,54 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aligned_memory.cpp
+//
+// Identification: src/common/util/aligned_memory.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/aligned_memory.h"
+
+#include <sys/mman.h>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include "common/config.h"
+
+namespace bustub {
+
+void AlignedMemoryDeleter::operator()(char *data) const {
+  if (data == nullptr) {
+    return;
+  }
+  if (size_ >= HUGE_PAGE_SIZE) {
+    munmap(data, size_);
+  } else {
+    ::operator delete[](data, std::align_val_t(DIRECT_IO_ALIGNMENT));
+  }
+}
+
+AlignedBuffer AlignedMemory::Allocate(size_t size) {
+  if (size < HUGE_PAGE_SIZE) {
+    auto *data = static_cast<char *>(::operator new[](size, std::align_val_t(DIRECT_IO_ALIGNMENT)));
+    memset(data, 0, size);
+    return AlignedBuffer(data, AlignedMemoryDeleter{size});
+  }
+  // Anonymous mappings are zeroed and page aligned; the advice is only a hint and may be ignored.
+  void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (data == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  madvise(data, size, MADV_HUGEPAGE);
+  return AlignedBuffer(static_cast<char *>(data), AlignedMemoryDeleter{size});
+}
+
+bool AlignedMemory::IsAligned(const void *data) {
+  return reinterpret_cast<uintptr_t>(data) % DIRECT_IO_ALIGNMENT == 0;
+}
+
+}  // namespace bustub
@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// crc32c.cpp
+//
+// Identification: src/common/util/crc32c.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/crc32c.h"
+
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+namespace bustub {
+
+/** The CRC-32C polynomial, bit reversed. */
+static constexpr uint32_t CRC32C_POLYNOMIAL = 0x82F63B78;
+/** The length of each of the three streams that the hardware implementation interleaves. */
+static constexpr size_t STREAM_BLOCK_SIZE = 256;
+
+/** Tables of the slicing-by-8 implementation: table_[k][b] is the CRC of byte b followed by k zero bytes. */
+struct SlicingTables {
+  SlicingTables() {
+    for (uint32_t b = 0; b < 256; b++) {
+      uint32_t crc = b;
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc >> 1) ^ ((crc & 1) != 0 ? CRC32C_POLYNOMIAL : 0);
+      }
+      table_[0][b] = crc;
+    }
+    for (int k = 1; k < 8; k++) {
+      for (uint32_t b = 0; b < 256; b++) {
+        table_[k][b] = (table_[k - 1][b] >> 8) ^ table_[0][table_[k - 1][b] & 0xff];
+      }
+    }
+  }
+  uint32_t table_[8][256];
+};
+
+static const SlicingTables &GetSlicingTables() {
+  static const SlicingTables tables;
+  return tables;
+}
+
+/** Updates an unconditioned CRC with the table implementation. */
+static uint32_t UpdateSoftware(uint32_t crc, const uint8_t *data, size_t size) {
+  const auto &table = GetSlicingTables().table_;
+  while (size > 0 && (reinterpret_cast<uintptr_t>(data) & 7) != 0) {
+    crc = table[0][(crc ^ *data++) & 0xff] ^ (crc >> 8);
+    size--;
+  }
+  while (size >= 8) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+    word ^= crc;
+    crc = table[7][word & 0xff] ^ table[6][(word >> 8) & 0xff] ^ table[5][(word >> 16) & 0xff] ^
+          table[4][(word >> 24) & 0xff] ^ table[3][(word >> 32) & 0xff] ^ table[2][(word >> 40) & 0xff] ^
+          table[1][(word >> 48) & 0xff] ^ table[0][word >> 56];
+    data += 8;
+    size -= 8;
+  }
+  while (size > 0) {
+    crc = table[0][(crc ^ *data++) & 0xff] ^ (crc >> 8);
+    size--;
+  }
+  return crc;
+}
+
+#if defined(__x86_64__)
+/**
+ * Appending STREAM_BLOCK_SIZE zero bytes to data is a linear map of its unconditioned CRC. table_[k][b] is the image of
+ * byte b at byte position k of the CRC, so the image of a CRC is the xor of four lookups.
+ */
+struct ShiftTables {
+  ShiftTables() {
+    uint8_t zeros[STREAM_BLOCK_SIZE] = {};
+    for (int k = 0; k < 4; k++) {
+      for (uint32_t b = 0; b < 256; b++) {
+        table_[k][b] = UpdateSoftware(b << (8 * k), zeros, sizeof(zeros));
+      }
+    }
+  }
+  uint32_t Shift(uint32_t crc) const {
+    return table_[0][crc & 0xff] ^ table_[1][(crc >> 8) & 0xff] ^ table_[2][(crc >> 16) & 0xff] ^
+           table_[3][crc >> 24];
+  }
+  uint32_t table_[4][256];
+};
+
+static const ShiftTables &GetShiftTables() {
+  static const ShiftTables tables;
+  return tables;
+}
+
+/**
+ * Updates an unconditioned CRC with the crc32 instruction. Its latency is three cycles but it issues every cycle, so
+ * three independent streams over adjacent blocks run at full speed; their CRCs are then combined by shifting.
+ */
+__attribute__((target("sse4.2"))) static uint32_t UpdateHardware(uint32_t crc, const uint8_t *data, size_t size) {
+  while (size > 0 && (reinterpret_cast<uintptr_t>(data) & 7) != 0) {
+    crc = _mm_crc32_u8(crc, *data++);
+    size--;
+  }
+  if (size >= 3 * STREAM_BLOCK_SIZE) {
+    const ShiftTables &shift = GetShiftTables();
+    do {
+      uint64_t crc0 = crc;
+      uint64_t crc1 = 0;
+      uint64_t crc2 = 0;
+      for (size_t i = 0; i < STREAM_BLOCK_SIZE; i += 8) {
+        uint64_t word0;
+        uint64_t word1;
+        uint64_t word2;
+        memcpy(&word0, data + i, sizeof(word0));
+        memcpy(&word1, data + STREAM_BLOCK_SIZE + i, sizeof(word1));
+        memcpy(&word2, data + 2 * STREAM_BLOCK_SIZE + i, sizeof(word2));
+        crc0 = _mm_crc32_u64(crc0, word0);
+        crc1 = _mm_crc32_u64(crc1, word1);
+        crc2 = _mm_crc32_u64(crc2, word2);
+      }
+      crc = shift.Shift(shift.Shift(static_cast<uint32_t>(crc0)) ^ static_cast<uint32_t>(crc1)) ^
+            static_cast<uint32_t>(crc2);
+      data += 3 * STREAM_BLOCK_SIZE;
+      size -= 3 * STREAM_BLOCK_SIZE;
+    } while (size >= 3 * STREAM_BLOCK_SIZE);
+  }
+  uint64_t crc64 = crc;
+  while (size >= 8) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+    crc64 = _mm_crc32_u64(crc64, word);
+    data += 8;
+    size -= 8;
+  }
+  crc = static_cast<uint32_t>(crc64);
+  while (size > 0) {
+    crc = _mm_crc32_u8(crc, *data++);
+    size--;
+  }
+  return crc;
+}
+#endif
+
+bool Crc32c::HasHardwareSupport() {
+#if defined(__x86_64__)
+  static const bool supported = __builtin_cpu_supports("sse4.2");
+  return supported;
+#else
+  return false;
+#endif
+}
+
+uint32_t Crc32c::Compute(const void *data, size_t size, uint32_t crc) {
+#if defined(__x86_64__)
+  if (HasHardwareSupport()) {
+    return ~UpdateHardware(~crc, static_cast<const uint8_t *>(data), size);
+  }
+#endif
+  return ComputeSoftware(data, size, crc);
+}
+
+uint32_t Crc32c::ComputeSoftware(const void *data, size_t size, uint32_t crc) {
+  return ~UpdateSoftware(~crc, static_cast<const uint8_t *>(data), size);
+}
+
+}  // namespace bustub
@@ -0,0 +1,175 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lz_codec.cpp
+//
+// Identification: src/common/util/lz_codec.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/lz_codec.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace bustub {
+
+/** Matches shorter than this are stored as literals. */
+static constexpr size_t MIN_MATCH = 4;
+/** The largest distance back to a match that an offset can hold. */
+static constexpr size_t MAX_OFFSET = 65535;
+/** The compressor finds matches through a hash table of 2^HASH_BITS recent positions. */
+static constexpr int HASH_BITS = 12;
+/** Every 2^SKIP_SHIFT bytes without a match, the compressor steps one byte further, to skip noise quickly. */
+static constexpr int SKIP_SHIFT = 5;
+
+static uint32_t Load32(const uint8_t *data) {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+static uint32_t Hash(uint32_t sequence) { return (sequence * 2654435761U) >> (32 - HASH_BITS); }
+
+/** Writes the extra bytes of a length whose nibble is 15. */
+static uint8_t *WriteLength(uint8_t *out, size_t length) {
+  for (length -= 15; length >= 255; length -= 255) {
+    *out++ = 255;
+  }
+  *out++ = static_cast<uint8_t>(length);
+  return out;
+}
+
+/** Reads the extra bytes of a length whose nibble is 15. */
+static bool ReadLength(const uint8_t **in, const uint8_t *end, size_t *length) {
+  uint8_t byte;
+  do {
+    if (*in == end) {
+      return false;
+    }
+    byte = *(*in)++;
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+/**
+ * Appends a sequence of literals and a match; a match length of 0 makes it the last sequence.
+ * @return the end of the output, nullptr if the sequence does not fit before out_end
+ */
+static uint8_t *WriteSequence(uint8_t *out, const uint8_t *out_end, const uint8_t *literals, size_t num_literals,
+                              size_t offset, size_t match_length) {
+  size_t match_code = match_length == 0 ? 0 : match_length - MIN_MATCH;
+  size_t size = 1 + num_literals + (num_literals < 15 ? 0 : (num_literals - 15) / 255 + 1);
+  if (match_length != 0) {
+    size += 2 + (match_code < 15 ? 0 : (match_code - 15) / 255 + 1);
+  }
+  if (size > static_cast<size_t>(out_end - out)) {
+    return nullptr;
+  }
+  uint8_t *token = out++;
+  *token = static_cast<uint8_t>(((num_literals < 15 ? num_literals : 15) << 4) | (match_code < 15 ? match_code : 15));
+  if (num_literals >= 15) {
+    out = WriteLength(out, num_literals);
+  }
+  memcpy(out, literals, num_literals);
+  out += num_literals;
+  if (match_length == 0) {
+    return out;
+  }
+  *out++ = static_cast<uint8_t>(offset);
+  *out++ = static_cast<uint8_t>(offset >> 8);
+  if (match_code >= 15) {
+    out = WriteLength(out, match_code);
+  }
+  return out;
+}
+
+size_t LZCodec::Compress(const char *src, size_t size, char *dst, size_t capacity) {
+  const auto *in = reinterpret_cast<const uint8_t *>(src);
+  auto *out = reinterpret_cast<uint8_t *>(dst);
+  const uint8_t *out_end = out + capacity;
+  // Positions plus one, so that zero marks an empty entry.
+  uint32_t table[1 << HASH_BITS];
+  memset(table, 0, sizeof(table));
+
+  size_t pos = 0;
+  size_t anchor = 0;
+  while (pos + MIN_MATCH <= size) {
+    uint32_t sequence = Load32(in + pos);
+    uint32_t &entry = table[Hash(sequence)];
+    size_t candidate = entry;
+    entry = static_cast<uint32_t>(pos + 1);
+    if (candidate == 0 || pos - (candidate - 1) > MAX_OFFSET || Load32(in + candidate - 1) != sequence) {
+      pos += 1 + ((pos - anchor) >> SKIP_SHIFT);
+      continue;
+    }
+    size_t match = candidate - 1;
+    size_t length = MIN_MATCH;
+    while (pos + length < size && in[match + length] == in[pos + length]) {
+      length++;
+    }
+    out = WriteSequence(out, out_end, in + anchor, pos - anchor, pos - match, length);
+    if (out == nullptr) {
+      return 0;
+    }
+    pos += length;
+    anchor = pos;
+  }
+  out = WriteSequence(out, out_end, in + anchor, size - anchor, 0, 0);
+  return out == nullptr ? 0 : out - reinterpret_cast<uint8_t *>(dst);
+}
+
+bool LZCodec::Decompress(const char *src, size_t size, char *dst, size_t dst_size) {
+  const auto *in = reinterpret_cast<const uint8_t *>(src);
+  const uint8_t *in_end = in + size;
+  auto *out = reinterpret_cast<uint8_t *>(dst);
+  const uint8_t *out_begin = out;
+  const uint8_t *out_end = out + dst_size;
+  while (in < in_end) {
+    uint8_t token = *in++;
+    size_t num_literals = token >> 4;
+    if (num_literals == 15 && !ReadLength(&in, in_end, &num_literals)) {
+      return false;
+    }
+    if (num_literals > static_cast<size_t>(in_end - in) || num_literals > static_cast<size_t>(out_end - out)) {
+      return false;
+    }
+    memcpy(out, in, num_literals);
+    in += num_literals;
+    out += num_literals;
+    if (in == in_end) {
+      break;
+    }
+
+    if (in_end - in < 2) {
+      return false;
+    }
+    size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+    in += 2;
+    size_t length = token & 15;
+    if (length == 15 && !ReadLength(&in, in_end, &length)) {
+      return false;
+    }
+    length += MIN_MATCH;
+    if (offset == 0 || offset > static_cast<size_t>(out - out_begin) || length > static_cast<size_t>(out_end - out)) {
+      return false;
+    }
+    const uint8_t *match = out - offset;
+    if (offset >= length) {
+      memcpy(out, match, length);
+      out += length;
+    } else {
+      // The match overlaps the bytes it produces, e.g. a run of one repeated byte.
+      for (size_t i = 0; i < length; i++) {
+        *out++ = *match++;
+      }
+    }
+  }
+  return out == out_end;
+}
+
+}  // namespace bustub
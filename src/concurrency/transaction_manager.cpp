@@ -30,7 +30,8 @@ Transaction *TransactionManager::Begin(Transaction *txn) {
   }
 
   if (enable_logging) {
-    // TODO(student): Add logging here.
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::BEGIN);
+    txn->SetPrevLSN(log_manager_->AppendLogRecord(&log_record));
   }
 
   txn_map[txn->GetTransactionId()] = txn;
@@ -54,7 +55,10 @@ void TransactionManager::Commit(Transaction *txn) {
   write_set->clear();
 
   if (enable_logging) {
-    // TODO(student): add logging here
+    // The transaction commits once its commit record is durable, in a flush shared with other commits.
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::COMMIT);
+    txn->SetPrevLSN(log_manager_->AppendLogRecord(&log_record));
+    log_manager_->WaitForFlush(txn->GetPrevLSN());
   }
 
   // Release all the locks.
@@ -84,7 +88,8 @@ void TransactionManager::Abort(Transaction *txn) {
   write_set->clear();
 
   if (enable_logging) {
-    // TODO(student): add logging here
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::ABORT);
+    txn->SetPrevLSN(log_manager_->AppendLogRecord(&log_record));
   }
 
   // Release all the locks.
@@ -13,10 +13,33 @@
 
 namespace bustub {
 
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx) {}
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
 
-void SeqScanExecutor::Init() {}
+void SeqScanExecutor::Init() {
+  BufferQuota::Scope quota_scope{exec_ctx_->GetBufferQuota()};
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
+  iter_ = std::make_unique<TableIterator>(table_info_->table_->Begin(exec_ctx_->GetTransaction(), &ring_));
+}
 
-bool SeqScanExecutor::Next(Tuple *tuple) { return false; }
+bool SeqScanExecutor::Next(Tuple *tuple) {
+  BufferQuota::Scope quota_scope{exec_ctx_->GetBufferQuota()};
+  const Schema *table_schema = &table_info_->schema_;
+  const AbstractExpression *predicate = plan_->GetPredicate();
+  while (*iter_ != table_info_->table_->End()) {
+    Tuple candidate = **iter_;
+    ++(*iter_);
+    if (predicate != nullptr && !predicate->Evaluate(&candidate, table_schema).GetAs<bool>()) {
+      continue;
+    }
+    std::vector<Value> values;
+    for (const auto &column : GetOutputSchema()->GetColumns()) {
+      values.push_back(column.GetExpr()->Evaluate(&candidate, table_schema));
+    }
+    *tuple = Tuple(values, GetOutputSchema());
+    return true;
+  }
+  return false;
+}
 
 }  // namespace bustub
@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * ARCReplacer implements the Adaptive Replacement Cache policy (Megiddo and Modha, FAST '03).
+ *
+ * Resident frames are kept in two LRU lists: T1 holds pages referenced once since they were loaded, T2 holds pages
+ * referenced at least twice. Evicted pages are remembered by page id in the ghost lists B1 and B2. A miss on a page in
+ * B1 means T1 was too small and grows its target size, a miss on a page in B2 shrinks it, so the split between recency
+ * and frequency tunes itself to the workload. Page ids are learned through RecordPage.
+ *
+ * Only Pin is a reference; Unpin and SetEvictable leave the frame where it is, so the buffer pool holds a frame with
+ * SetEvictable when a fetch repeats the previous one, e.g. a scan's once per tuple. Pinned frames stay in their list but
+ * are skipped by Victim; if the list that ARC would evict from has no unpinned frame, the other list is used.
+ */
+class ARCReplacer : public Replacer {
+ public:
+  /**
+   * Create a new ARCReplacer.
+   * @param num_pages the maximum number of pages the ARCReplacer will be required to store
+   */
+  explicit ARCReplacer(size_t num_pages);
+
+  /**
+   * Destroys the ARCReplacer.
+   */
+  ~ARCReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool evictable) override;
+
+  size_t Size() override;
+
+  void PeekVictims(size_t max_frames, std::vector<frame_id_t> *frames) override;
+
+  void Resize(size_t num_pages) override;
+
+  void RecordPage(frame_id_t frame_id, page_id_t page_id) override;
+
+  /** @return the current target size of T1 */
+  size_t GetTargetT1Size();
+
+ private:
+  /** Bookkeeping of a resident frame. */
+  struct FrameEntry {
+    /** The page held by the frame, INVALID_PAGE_ID if the buffer pool never told us. */
+    page_id_t page_id_{INVALID_PAGE_ID};
+    /** True if the frame is in T2, false if it is in T1. */
+    bool in_t2_{false};
+    /** Position of the frame in its list. */
+    std::list<frame_id_t>::iterator pos_;
+    /** True if the frame is unpinned. */
+    bool evictable_{false};
+    /**
+     * True between RecordPage and the first Pin. That Pin is the reference the page was loaded for, or the first fetch
+     * of a page read ahead, and keeps the page in T1; only the next one is a second reference.
+     */
+    bool fresh_{false};
+  };
+
+  /** Adds a frame at the MRU end of T1 or T2. The caller must hold latch_. */
+  void Insert(frame_id_t frame_id, page_id_t page_id, bool in_t2);
+
+  /** Removes a frame from its list and from frames_. The caller must hold latch_. */
+  void Erase(frame_id_t frame_id);
+
+  /** Finds the least recently used unpinned frame of a list. The caller must hold latch_. */
+  bool FindEvictable(const std::list<frame_id_t> &list, frame_id_t *frame_id);
+
+  /** Removes a page from a ghost list if it is there. The caller must hold latch_. */
+  static bool EraseGhost(std::list<page_id_t> *ghosts, std::unordered_map<page_id_t, std::list<page_id_t>::iterator> *map,
+                         page_id_t page_id);
+
+  /** Drops the oldest ghosts until |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c. The caller must hold latch_. */
+  void TrimGhosts();
+
+  /** The cache size c. */
+  size_t capacity_;
+  /** The adaptive target size p of T1. */
+  size_t target_t1_size_{0};
+  /** Number of unpinned frames. */
+  size_t evictable_count_{0};
+  /** Resident frames seen once and seen at least twice, most recently used at the front. */
+  std::list<frame_id_t> t1_;
+  std::list<frame_id_t> t2_;
+  /** Ghost page ids evicted from T1 and from T2, most recently evicted at the front. */
+  std::list<page_id_t> b1_;
+  std::list<page_id_t> b2_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> b1_map_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> b2_map_;
+  /** Every frame in T1 or T2. */
+  std::unordered_map<frame_id_t, FrameEntry> frames_;
+  /** Protects all of the above. */
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -12,11 +12,26 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
 #include <list>
-#include <mutex>  // NOLINT
+#include <memory>
+#include <mutex>   // NOLINT
+#include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include "buffer/buffer_pool_stats.h"
+#include "buffer/buffer_quota.h"
+#include "buffer/buffer_ring.h"
 #include "buffer/lru_replacer.h"
+#include "buffer/page_trace.h"
+#include "buffer/replacer.h"
+#include "common/util/aligned_memory.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
@@ -27,22 +42,29 @@ namespace bustub {
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
  */
 class BufferPoolManager {
+  // The parallel buffer pool routes page operations to its instances and installs pages it allocated itself.
+  friend class ParallelBufferPoolManager;
+
  public:
   enum class CallbackType { BEFORE, AFTER };
   using bufferpool_callback_fn = void (*)(enum CallbackType, const page_id_t page_id);
+  /** Reads the id of the next page out of a page of a linked list of pages, INVALID_PAGE_ID at the end of the list. */
+  using page_link_fn = page_id_t (*)(Page *page);
 
   /**
    * Creates a new BufferPoolManager.
    * @param pool_size the size of the buffer pool
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer the replacement policy, owned by the buffer pool from now on (nullptr = LRUReplacer)
    */
-  BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr);
+  BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                    Replacer *replacer = nullptr);
 
   /**
    * Destroys an existing BufferPoolManager.
    */
-  ~BufferPoolManager();
+  virtual ~BufferPoolManager();
 
   /** Grading function. Do not modify! */
   Page *FetchPage(page_id_t page_id, bufferpool_callback_fn callback = nullptr) {
@@ -52,6 +74,30 @@ class BufferPoolManager {
     return result;
   }
 
+  /**
+   * Fetches a page on behalf of a sequential scan. If the page is not resident, it is loaded into one of the frames
+   * recycled by the ring instead of a frame chosen by the replacer.
+   * @param page_id id of page to be fetched
+   * @param ring the access strategy of the scan, nullptr to fetch as usual
+   * @param callback grading callback
+   * @return the requested page
+   */
+  Page *FetchPage(page_id_t page_id, BufferRing *ring, bufferpool_callback_fn callback = nullptr) {
+    GradingCallback(callback, CallbackType::BEFORE, page_id);
+    auto *result = FetchPageImpl(page_id, ring);
+    GradingCallback(callback, CallbackType::AFTER, page_id);
+    return result;
+  }
+
+  /**
+   * Fetches a page that the caller fetched and unpinned just before, like a scan that comes back to its page once per
+   * tuple. The page is pinned as by FetchPage, but the replacer does not count the fetch as another reference to it.
+   * @param page_id id of page to be fetched
+   * @param ring the access strategy of the scan, nullptr to fetch as usual
+   * @return the requested page
+   */
+  Page *FetchPageAgain(page_id_t page_id, BufferRing *ring = nullptr) { return FetchPageImpl(page_id, ring, false); }
+
   /** Grading function. Do not modify! */
   bool UnpinPage(page_id_t page_id, bool is_dirty, bufferpool_callback_fn callback = nullptr) {
     GradingCallback(callback, CallbackType::BEFORE, page_id);
@@ -91,11 +137,85 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
-  /** @return pointer to all the pages in the buffer pool */
-  Page *GetPages() { return pages_; }
+  /**
+   * Fetches a child of an index page through a swizzled pointer: the frame the child was found in the last time it
+   * was fetched from this slot of the parent. While the child stays resident this skips the page table. A pointer
+   * that went stale because the child was evicted or the slots of the parent moved is detected, since the frame then
+   * holds another page, and the call falls back to FetchPage and swizzles the slot again.
+   * @param parent the pinned parent page
+   * @param slot the slot of the parent that points to the child
+   * @param child_id id of the child page
+   * @return the pinned child page, nullptr if it is not resident and every frame is pinned
+   */
+  Page *FetchChildPage(Page *parent, int slot, page_id_t child_id) { return FetchChildPageImpl(parent, slot, child_id); }
+
+  /**
+   * Unpins a page without looking it up in the page table.
+   * @param page a page pinned by this buffer pool
+   * @param is_dirty true if the page should be marked as dirty, false otherwise
+   * @return false if the page was not pinned, true otherwise
+   */
+  bool UnpinPage(Page *page, bool is_dirty) { return UnpinPageImpl(page, is_dirty); }
+
+  /**
+   * Deletes a page that may still be pinned by readers that reached it before it became unreachable. A pinned page is
+   * deleted, and its id deallocated, when its last pin is dropped.
+   * @param page_id id of the page to be deleted
+   */
+  void DeletePageWhenUnpinned(page_id_t page_id) { DeletePageWhenUnpinnedImpl(page_id); }
+
+  /**
+   * Asks the buffer pool to read the given pages in the background and returns right away. The pages are loaded into
+   * unpinned frames; pages that are already resident are left alone and pages that find every frame pinned are
+   * skipped.
+   * @param page_ids ids of the pages that are going to be fetched soon
+   */
+  void PrefetchPages(const std::vector<page_id_t> &page_ids);
+
+  /**
+   * Asks the buffer pool to read up to num_pages pages of a linked list of pages in the background, starting with
+   * page_id, and returns right away. Every page is read in before its link is followed.
+   * @param page_id id of the first page to be read
+   * @param num_pages the maximum number of pages to read
+   * @param next_page reads the id of the next page of the list out of a page
+   */
+  void PrefetchPageChain(page_id_t page_id, size_t num_pages, page_link_fn next_page);
+
+  /**
+   * Grows or shrinks the buffer pool while it is in use. New frames go to the free list. Removed frames are taken out
+   * of circulation right away and evicted once they are unpinned, writing back dirty pages; the call returns when all
+   * of them are evicted, so the calling thread must not hold pins on them.
+   * @param new_size the new number of frames
+   */
+  virtual void Resize(size_t new_size);
+
+  /** @return a snapshot of the counters of the buffer pool */
+  virtual BufferPoolStats GetStats();
+
+  /** Sets the counters of the buffer pool back to zero. The pinned frame count is not a counter and stays. */
+  virtual void ResetStats();
+
+  /**
+   * Starts recording the page accesses of FetchPage, FetchChildPage and NewPage into a trace file, to be replayed by
+   * the replacer simulator. A trace that is being recorded is closed first.
+   * @param file_name the name of the trace file
+   */
+  virtual void StartTrace(const std::string &file_name);
+
+  /** Stops recording page accesses and closes the trace file. Does nothing if no trace is being recorded. */
+  virtual void StopTrace();
+
+  /** @return pointer to the pages the buffer pool was created with; frames added by Resize are not part of it */
+  virtual Page *GetPages() { return frames_.empty() ? nullptr : frames_[0]; }
 
   /** @return size of the buffer pool */
-  size_t GetPoolSize() { return pool_size_; }
+  virtual size_t GetPoolSize() { return pool_size_; }
+
+  /** @return the size of the pages in the buffer pool, the page size of the database file */
+  size_t GetPageSize() const { return page_size_; }
+
+  /** @return the number of bytes of a page that are free for its content, all but the checksum trailer */
+  size_t GetUsablePageSize() const { return page_size_ - PAGE_CHECKSUM_SIZE; }
 
  protected:
   /**
@@ -114,9 +234,12 @@ class BufferPoolManager {
   /**
    * Fetch the requested page from the buffer pool.
    * @param page_id id of page to be fetched
+   * @param ring if not nullptr, a miss recycles one of the ring's frames
+   * @param reference false if the fetch repeats the caller's previous one and is not a reference for the replacer
    * @return the requested page
+   * @throws Exception of type CORRUPTION if the page does not match its checksum
    */
-  Page *FetchPageImpl(page_id_t page_id);
+  virtual Page *FetchPageImpl(page_id_t page_id, BufferRing *ring = nullptr, bool reference = true);
 
   /**
    * Unpin the target page from the buffer pool.
@@ -124,49 +247,366 @@ class BufferPoolManager {
    * @param is_dirty true if the page should be marked as dirty, false otherwise
    * @return false if the page pin count is <= 0 before this call, true otherwise
    */
-  bool UnpinPageImpl(page_id_t page_id, bool is_dirty);
+  virtual bool UnpinPageImpl(page_id_t page_id, bool is_dirty);
+
+  /**
+   * Fetches a child page through the swizzled pointer in the given slot of its parent.
+   * @param parent the pinned parent page
+   * @param slot the slot of the parent that points to the child
+   * @param child_id id of the child page
+   * @return the pinned child page
+   */
+  virtual Page *FetchChildPageImpl(Page *parent, int slot, page_id_t child_id);
+
+  /**
+   * Unpins a page that is known to be pinned in this buffer pool.
+   * @param page the pinned page
+   * @param is_dirty true if the page should be marked as dirty, false otherwise
+   * @return false if the page was not pinned, true otherwise
+   */
+  virtual bool UnpinPageImpl(Page *page, bool is_dirty);
 
   /**
    * Flushes the target page to disk.
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
    * @return false if the page could not be found in the page table, true otherwise
    */
-  bool FlushPageImpl(page_id_t page_id);
+  virtual bool FlushPageImpl(page_id_t page_id);
 
   /**
    * Creates a new page in the buffer pool.
    * @param[out] page_id id of created page
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
-  Page *NewPageImpl(page_id_t *page_id);
+  virtual Page *NewPageImpl(page_id_t *page_id);
 
   /**
    * Deletes a page from the buffer pool.
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
    */
-  bool DeletePageImpl(page_id_t page_id);
+  virtual bool DeletePageImpl(page_id_t page_id);
+
+  /**
+   * Deletes a page from the buffer pool now, or with its last unpin if it is pinned.
+   * @param page_id id of page to be deleted
+   */
+  virtual void DeletePageWhenUnpinnedImpl(page_id_t page_id);
+
+  /**
+   * Flushes all the dirty pages in the buffer pool to disk, then syncs the file once.
+   */
+  virtual void FlushAllPagesImpl();
+
+  /**
+   * Reads a page into an unpinned frame unless it is already resident. Called by the prefetch threads.
+   * @param page_id id of the page to be read
+   * @param next_page if not nullptr, used to read the id of the next page out of the page
+   * @param[out] next_page_id id of the next page, INVALID_PAGE_ID if next_page is nullptr
+   * @return false if the page could not be read because every frame is pinned, true otherwise
+   */
+  virtual bool PrefetchPageImpl(page_id_t page_id, page_link_fn next_page, page_id_t *next_page_id);
+
+  /**
+   * Reads the pages that are not resident into unpinned frames with all reads in flight at once. Called by the prefetch
+   * threads for the pages of PrefetchPages. Stops at the first page that finds every frame pinned.
+   * @param page_ids ids of the pages to be read
+   */
+  virtual void PrefetchBatchImpl(const std::vector<page_id_t> &page_ids);
+
+  /**
+   * Stops the prefetch threads and drops the requests they have not served yet. Safe to call more than once.
+   */
+  void StopPrefetchThreads();
+
+  /**
+   * Stops the page cleaner. Pages it has not written back yet stay dirty. Safe to call more than once.
+   */
+  void StopPageCleaner();
+
+  /**
+   * Creates a new page with an id that was already allocated on disk by the caller.
+   * @param page_id id of the page to be created
+   * @return nullptr if every frame is pinned, otherwise pointer to the new page
+   */
+  Page *NewPageWithIdImpl(page_id_t page_id);
+
+  /** Reads a page through the disk manager and records the latency. */
+  void ReadFromDisk(page_id_t page_id, char *data);
+
+  /** Writes a page through the disk manager and records the latency. */
+  void WriteToDisk(page_id_t page_id, const char *data);
+
+  /**
+   * Writes a batch of pages through DiskManager::WritePages and records the latency, spread evenly over the pages.
+   * @param pages the ids and raw data of the pages
+   */
+  void WriteBatchToDisk(std::vector<std::pair<page_id_t, const char *>> *pages);
+
+  /**
+   * Reads a batch of pages through DiskManager::ReadPageAsync, all of them in flight at once, and records the latency,
+   * spread evenly over the pages.
+   * @param pages the ids of the pages and the buffers to read them into
+   * @return for each page, false if it could not be read or does not match its checksum
+   */
+  std::vector<bool> ReadBatchFromDisk(const std::vector<std::pair<page_id_t, char *>> &pages);
+
+  /**
+   * Writes back every dirty page without syncing the file. The pages are pinned in batches of FLUSH_BATCH_PAGES and
+   * each batch is copied under the page latches and written in page id order without latch_, adjacent pages with a
+   * single write.
+   */
+  void FlushDirtyPages();
+
+  /**
+   * Makes the buffer pool record its page accesses into the given trace, or stop recording them.
+   * @param trace the trace, shared with other instances of a parallel buffer pool; nullptr to stop recording
+   */
+  void SetTrace(std::shared_ptr<PageTraceWriter> trace);
+
+  /** Appends a page access to the trace, if one is being recorded. The caller must hold latch_. */
+  void TracePageAccess(page_id_t page_id, PageAccessType type) {
+    if (trace_ != nullptr) {
+      trace_->Record(page_id, type);
+    }
+  }
+
+  /** Counts the eviction of the page in the given frame as clean or dirty. */
+  void CountEviction(Page *page);
+
+  /**
+   * Allocates num_frames more frames in one chunk and appends them to frames_. Frames never move, so pointers to pages
+   * stay valid while the pool grows. The caller must hold latch_ unless the pool is being constructed.
+   * @param num_frames number of frames to allocate
+   */
+  void AllocateFrames(size_t num_frames);
+
+  /**
+   * Drops one pin of a frame. An unpinned frame goes to the replacer, unless Resize is removing it or the frame holds
+   * no page, which sends it to the free list. A page that is waiting to be deleted is deleted. The caller must hold
+   * latch_.
+   * @param frame_id id of the pinned frame
+   */
+  void UnpinFrame(frame_id_t frame_id);
+
+  /**
+   * Returns an unused frame to the free list, unless Resize is removing it. The caller must hold latch_.
+   * @param frame_id id of the frame
+   */
+  void ReleaseFrame(frame_id_t frame_id);
+
+  /**
+   * Picks a frame to hold a page, preferring the free list over the replacer. The victim is removed from the page
+   * table; if it is dirty it is recorded in evicting_pages_ until LoadFrame has written it back. The caller must hold
+   * latch_.
+   * @param[out] frame_id id of the frame that can be reused
+   * @param[out] victim_page_id id of the dirty page that must be written back first, INVALID_PAGE_ID if none
+   * @return false if every frame is pinned, true otherwise
+   */
+  bool FindFreeFrame(frame_id_t *frame_id, page_id_t *victim_page_id);
+
+  /**
+   * Picks the next frame of a full ring for reuse, if it still holds the page the ring loaded into it and nobody has
+   * it pinned. Like FindFreeFrame, a dirty page in it is recorded for write-back. The caller must hold latch_.
+   * @param ring the ring of the scan
+   * @param[out] frame_id id of the frame that can be reused
+   * @param[out] victim_page_id id of the dirty page that must be written back first, INVALID_PAGE_ID if none
+   * @return false if the ring is not full yet or its next frame cannot be reused, true otherwise
+   */
+  bool FindRingFrame(BufferRing *ring, frame_id_t *frame_id, page_id_t *victim_page_id);
+
+  /**
+   * Remembers that a scan placed a page into the given frame so that it recycles the frame once its ring is full. The
+   * frame of the slot being replaced goes back to the free list if it is still clean and unused. The caller must hold
+   * latch_.
+   * @param ring the ring of the scan
+   * @param frame_id id of the frame holding the page
+   * @param page_id id of the page
+   */
+  void RecordRingFrame(BufferRing *ring, frame_id_t frame_id, page_id_t page_id);
+
+  /**
+   * Picks a frame to hold a page for the query owning the quota: once the query holds its quota of frames, the least
+   * recently used of them that is unpinned, otherwise a frame from FindFreeFrame. The caller must hold latch_.
+   * @param quota the quota of the query, nullptr if it has none
+   * @param[out] frame_id id of the frame that can be reused
+   * @param[out] victim_page_id id of the dirty page that must be written back first, INVALID_PAGE_ID if none
+   * @return false if every frame is pinned, true otherwise
+   */
+  bool FindQuotaOrFreeFrame(BufferQuota *quota, frame_id_t *frame_id, page_id_t *victim_page_id);
+
+  /**
+   * Picks the least recently used unpinned frame of a query that holds its quota of frames. Like FindFreeFrame, a
+   * dirty page in it is recorded for write-back. Frames that no longer hold the page the query loaded are forgotten on
+   * the way. The caller must hold latch_.
+   * @param quota the quota of the query
+   * @param[out] frame_id id of the frame that can be reused
+   * @param[out] victim_page_id id of the dirty page that must be written back first, INVALID_PAGE_ID if none
+   * @return false if the query is below its quota or all of its frames are pinned, true otherwise
+   */
+  bool FindQuotaFrame(BufferQuota *quota, frame_id_t *frame_id, page_id_t *victim_page_id);
+
+  /**
+   * Charges a frame that a query loads a page into to its quota, as its most recently used frame. The caller must hold
+   * latch_.
+   * @param quota the quota of the query
+   * @param frame_id id of the frame holding the page
+   * @param page_id id of the page
+   */
+  void RecordQuotaFrame(BufferQuota *quota, frame_id_t frame_id, page_id_t page_id);
+
+  /**
+   * Makes a frame the most recently used one of a query, if the query loaded the page in it. The caller must hold
+   * latch_.
+   * @param quota the quota of the query
+   * @param frame_id id of the frame the query found the page in
+   * @param page_id id of the page
+   */
+  void TouchQuotaFrame(BufferQuota *quota, frame_id_t frame_id, page_id_t page_id);
+
+  /**
+   * Maps a pinned page into the given frame and marks the frame as I/O in progress. The caller must hold latch_ and
+   * call LoadFrame next. The replacer only holds the frame; a caller that loads the page for a fetch also pins it
+   * there, so that a page read ahead has no reference until it is fetched.
+   * @param frame_id id of a frame returned by FindFreeFrame
+   * @param page_id id of the new page
+   * @return pointer to the new page
+   */
+  Page *InstallNewPage(frame_id_t frame_id, page_id_t page_id);
+
+  /**
+   * Writes back the victim and fills the frame with the page content while latch_ is released, then clears the I/O in
+   * progress state and wakes up the threads waiting on this frame.
+   * @param lock the held lock on latch_, it is held again on return
+   * @param page the page returned by InstallNewPage
+   * @param victim_page_id dirty page to write back first, INVALID_PAGE_ID if none
+   * @param read_from_disk true to read the page from disk, false to zero it out
+   * @throws Exception if the page cannot be read; the frame is given up and the pin of the caller dropped
+   */
+  void LoadFrame(std::unique_lock<std::mutex> *lock, Page *page, page_id_t victim_page_id, bool read_from_disk);
+
+  /**
+   * Waits until no older copy of the page is on its way to disk, neither from the frame it was evicted from nor from
+   * the page cleaner. The page id may not be handed out or deallocated before that write lands. latch_ is released
+   * while waiting.
+   * @param lock the held lock on latch_, it is held again on return
+   * @param page_id id of the page
+   */
+  void WaitForPageWrites(std::unique_lock<std::mutex> *lock, page_id_t page_id);
+
+  /**
+   * An optimistic reader may fetch a child that was deleted and deallocated before the reader found out that its
+   * parent changed, which loads a stale copy of the page under an id that is free again. A new page with that id takes
+   * over the frame of the copy, so that the reader's unpin still finds the frame it pinned.
+   * @param lock the held lock on latch_, it is held again on return; it is released while the copy is being read in
+   * @param page_id id of the new page
+   * @param quota the buffer quota of the calling query, nullptr if none
+   * @return the pinned and zeroed frame of the copy, nullptr if the page is not resident
+   */
+  Page *TakeOverStaleCopy(std::unique_lock<std::mutex> *lock, page_id_t page_id, BufferQuota *quota);
 
   /**
-   * Flushes all the pages in the buffer pool to disk.
+   * Removes the page of a frame whose read failed from the page table. The frame stays pinned by the threads waiting
+   * for it and goes to the free list with the last unpin. The caller must hold latch_.
+   * @param page the page that could not be read
+   */
+  void DropFrame(Page *page);
+
+  /**
+   * Deletes a page from the buffer pool and deallocates its id.
+   * @param page_id id of page to be deleted
+   * @param when_unpinned true to delete a pinned page with its last unpin, false to leave it alone
+   * @return false if the page is pinned, true otherwise
    */
-  void FlushAllPagesImpl();
+  bool RemovePage(page_id_t page_id, bool when_unpinned);
 
-  /** Number of pages in the buffer pool. */
-  size_t pool_size_;
-  /** Array of buffer pool pages. */
-  Page *pages_;
+  /** Number of pages in the buffer pool. Frames at or past it are being removed by Resize. */
+  std::atomic<size_t> pool_size_;
+  /** A block of frames allocated at once, starting with frame id first_frame_. */
+  struct PageChunk {
+    size_t first_frame_;
+    std::unique_ptr<Page[]> pages_;
+    /** The page data of the frames, page_size_ bytes each, aligned for O_DIRECT. */
+    AlignedBuffer data_;
+  };
+  /** The memory of the frames, in frame id order. */
+  std::vector<PageChunk> page_chunks_;
+  /** Buffer pool pages indexed by frame id, including frames past pool_size_ that were removed but not freed. */
+  std::vector<Page *> frames_;
+  /** Hit, miss, eviction and I/O counters. */
+  BufferPoolCounters counters_;
+  /** Serializes calls to Resize. */
+  std::mutex resize_latch_;
+  /** Signalled when a frame that Resize is removing becomes unpinned or unused. */
+  std::condition_variable resize_cv_;
   /** Pointer to the disk manager. */
-  DiskManager *disk_manager_ __attribute__((__unused__));
+  DiskManager *disk_manager_;
+  /** Size of the page data of every frame. */
+  size_t page_size_;
   /** Pointer to the log manager. */
-  LogManager *log_manager_ __attribute__((__unused__));
+  LogManager *log_manager_;
   /** Page table for keeping track of buffer pool pages. */
   std::unordered_map<page_id_t, frame_id_t> page_table_;
   /** Replacer to find unpinned pages for replacement. */
   Replacer *replacer_;
   /** List of free pages. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /** The trace the page accesses are recorded into, nullptr if none. */
+  std::shared_ptr<PageTraceWriter> trace_;
+  /** Dirty pages that were evicted but are still being written back, mapped to the frame doing the write. */
+  std::unordered_map<page_id_t, frame_id_t> evicting_pages_;
+  /** A read request of the prefetch threads: up to num_pages_ pages of a list of pages starting at page_id_. */
+  struct PrefetchRequest {
+    page_id_t page_id_;
+    size_t num_pages_;
+    page_link_fn next_page_;
+  };
+
+  /** Serves prefetch requests until StopPrefetchThreads is called. */
+  void RunPrefetchThread();
+
+  /** Queues prefetch requests, starting the prefetch threads on first use. */
+  void EnqueuePrefetchRequests(const std::vector<PrefetchRequest> &requests);
+
+  /** Runs a round of CleanPages every page_cleaner_interval until StopPageCleaner is called. */
+  void RunPageCleaner();
+
+  /**
+   * Writes back up to page_cleaner_max_pages dirty unpinned pages, the ones the replacer would evict first before the
+   * others, until at most page_cleaner_dirty_percent of the frames hold such pages. A page is written only once the log
+   * records up to its LSN are on disk. The pages are copied under latch_ and written in page id order without it.
+   *
+   * Only the page cleaner follows that write-ahead rule. A dirty victim that foreground eviction, a Resize or a flush
+   * writes back is written whatever its LSN, as before there was a page cleaner.
+   * @param lock the held lock on latch_, it is held again on return
+   */
+  void CleanPages(std::unique_lock<std::mutex> *lock);
+
+  /** Background thread writing back dirty pages ahead of the replacer, not started for an empty pool. */
+  std::thread page_cleaner_;
+  /** True once the page cleaner has been asked to exit. */
+  bool stop_page_cleaner_ = false;
+  /** Signalled when the page cleaner is asked to exit. */
+  std::condition_variable page_cleaner_cv_;
+  /** Pages of which the page cleaner is writing a copy. Their next write or read has to wait until it lands. */
+  std::unordered_set<page_id_t> cleaning_pages_;
+  /** Signalled when the page cleaner finished writing a batch of pages. */
+  std::condition_variable cleaning_cv_;
+  /** Prefetch requests that no prefetch thread has picked up yet. */
+  std::deque<PrefetchRequest> prefetch_queue_;
+  /** Background threads serving prefetch requests, started on first use. */
+  std::vector<std::thread> prefetch_threads_;
+  /** True once the prefetch threads have been asked to exit. */
+  bool stop_prefetch_ = false;
+  /** This latch protects prefetch_queue_, prefetch_threads_ and stop_prefetch_. */
+  std::mutex prefetch_latch_;
+  /** Signalled when a prefetch request is queued or the prefetch threads are asked to exit. */
+  std::condition_variable prefetch_cv_;
+  /**
+   * This latch protects page_table_, free_list_, frames_, evicting_pages_, cleaning_pages_, stop_page_cleaner_, trace_
+   * and the metadata (page id, pin count, dirty flag, I/O state) of every frame. It is never held across disk I/O on a
+   * frame that is marked as I/O in progress, nor while the page cleaner writes.
+   */
   std::mutex latch_;
 };
 }  // namespace bustub
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.h
+//
+// Identification: src/include/buffer/buffer_pool_stats.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <string>
+
+namespace bustub {
+
+/**
+ * Counts of disk operations by latency. Bucket 0 holds operations that took less than a microsecond, bucket i the ones
+ * that took [2^(i-1), 2^i) microseconds, and the last bucket everything slower.
+ */
+static constexpr size_t LATENCY_BUCKETS = 24;
+using LatencyHistogram = std::array<uint64_t, LATENCY_BUCKETS>;
+
+/**
+ * BufferPoolStats is a snapshot of the counters of a buffer pool, as returned by BufferPoolManager::GetStats. The
+ * counters are taken one by one while the pool keeps running, so they are not exactly consistent with each other.
+ */
+struct BufferPoolStats {
+  /** Fetches that found the page resident. */
+  uint64_t hits_{0};
+  /** Fetches that had to read the page from disk. */
+  uint64_t misses_{0};
+  /** Pages evicted without a write. */
+  uint64_t clean_evictions_{0};
+  /** Pages written back on eviction. */
+  uint64_t dirty_evictions_{0};
+  /** Fetches that waited for another thread's I/O on the page. */
+  uint64_t pin_waits_{0};
+  /** Frames pinned when the snapshot was taken. */
+  uint64_t pinned_frames_{0};
+  /** Latency of the page reads. */
+  LatencyHistogram read_latency_{};
+  /** Latency of the page writes, by evictions, flushes and the page cleaner alike. */
+  LatencyHistogram write_latency_{};
+
+  /** @return hits / (hits + misses), 0 if there were no fetches */
+  double HitRate() const;
+
+  /** @return the number of page reads */
+  uint64_t Reads() const;
+
+  /** @return the number of page writes */
+  uint64_t Writes() const;
+
+  /**
+   * @param histogram a latency histogram
+   * @param fraction a fraction of the operations, e.g. 0.99
+   * @return the upper bound in microseconds of the bucket that holds the given fraction of the operations
+   */
+  static uint64_t Percentile(const LatencyHistogram &histogram, double fraction);
+
+  /** Adds up the counters of another pool, e.g. of another instance. */
+  BufferPoolStats &operator+=(const BufferPoolStats &other);
+
+  /** @return the counters in a single line, for logging */
+  std::string ToString() const;
+};
+
+/**
+ * BufferPoolCounters are the live counters of a buffer pool. They are updated with relaxed atomics, so they cost
+ * nothing in terms of latching.
+ */
+class BufferPoolCounters {
+ public:
+  /** Adds one to a counter. */
+  static void Increment(std::atomic<uint64_t> *counter) { counter->fetch_add(1, std::memory_order_relaxed); }
+
+  /** Records a page read that took the given time. */
+  void RecordRead(std::chrono::nanoseconds latency) { Record(&read_latency_, latency); }
+
+  /** Records a page write that took the given time. */
+  void RecordWrite(std::chrono::nanoseconds latency) { Record(&write_latency_, latency); }
+
+  /**
+   * Copies the counters into a snapshot. The pinned frame count is left to the caller.
+   * @param[out] stats the snapshot
+   */
+  void Snapshot(BufferPoolStats *stats) const;
+
+  /** Sets every counter back to zero. */
+  void Reset();
+
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> clean_evictions_{0};
+  std::atomic<uint64_t> dirty_evictions_{0};
+  std::atomic<uint64_t> pin_waits_{0};
+
+ private:
+  using AtomicHistogram = std::array<std::atomic<uint64_t>, LATENCY_BUCKETS>;
+
+  static void Record(AtomicHistogram *histogram, std::chrono::nanoseconds latency);
+
+  AtomicHistogram read_latency_{};
+  AtomicHistogram write_latency_{};
+};
+
+}  // namespace bustub
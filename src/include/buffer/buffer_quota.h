@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_quota.h
+//
+// Identification: src/include/buffer/buffer_quota.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+
+/**
+ * BufferQuota caps the number of frames a single query loads pages into. Once the query holds quota_pages frames in a
+ * buffer pool instance, a page it fetches or creates is loaded into the least recently used of its own unpinned
+ * frames instead of a frame chosen by the replacer, like a local replacement policy. A query building a large hash
+ * table or aggregation therefore churns its own frames and leaves the pages of concurrent queries alone. If all of its
+ * frames are pinned, the query takes a frame from the replacer as usual and goes over its quota until it unpins them.
+ * Pages that are already resident are found and shared as usual; only the frames the query loaded count.
+ *
+ * The buffer pool charges the page accesses of a thread to the quota that is active on it through a Scope, so that
+ * table heaps, indexes and hash tables need not pass the quota along. A quota belongs to a single query and must not
+ * be active on several threads at once.
+ */
+class BufferQuota {
+  friend class BufferPoolManager;
+
+ public:
+  /**
+   * Creates a new BufferQuota.
+   * @param quota_pages the number of frames the query may load pages into in each buffer pool instance
+   */
+  explicit BufferQuota(size_t quota_pages) : quota_pages_(quota_pages) {}
+
+  /** @return the number of frames the query may load pages into in each buffer pool instance */
+  size_t GetQuotaPages() const { return quota_pages_; }
+
+  /**
+   * Scope charges the page accesses of the current thread to a quota while it is alive. Scopes nest; the previous
+   * quota is active again when the scope ends.
+   */
+  class Scope {
+   public:
+    /** @param quota the quota to charge, nullptr to charge none */
+    explicit Scope(BufferQuota *quota) : previous_(current_) { current_ = quota; }
+    ~Scope() { current_ = previous_; }
+
+    DISALLOW_COPY_AND_MOVE(Scope);
+
+   private:
+    BufferQuota *previous_;
+  };
+
+  /** @return the quota active on the current thread, nullptr if none */
+  static BufferQuota *Current() { return current_; }
+
+ private:
+  /** A frame that the query loaded a page into. */
+  struct Slot {
+    frame_id_t frame_id_;
+    page_id_t page_id_;
+  };
+
+  /** The frames used in one buffer pool instance, least recently used first. */
+  struct Frames {
+    std::list<Slot> slots_;
+    std::unordered_map<frame_id_t, std::list<Slot>::iterator> index_;
+  };
+
+  static thread_local BufferQuota *current_;
+
+  size_t quota_pages_;
+  std::unordered_map<const BufferPoolManager *, Frames> frames_;
+};
+
+}  // namespace bustub
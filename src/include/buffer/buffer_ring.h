@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_ring.h
+//
+// Identification: src/include/buffer/buffer_ring.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+
+/**
+ * BufferRing is the access strategy of a large sequential scan. When a scan passes its ring to FetchPage, a page that
+ * is not resident is loaded into one of a small set of frames that the scan recycles in order, instead of a frame
+ * chosen by the replacer. A scan over a table much larger than the buffer pool therefore displaces at most ring_size
+ * pages of the working set. Pages that are already resident are found and shared as usual.
+ *
+ * A ring only remembers which frames it used; a frame that was since pinned or reused by somebody else is simply
+ * replaced by a fresh one. Each buffer pool instance gets its own set of frames. A ring belongs to a single scan and
+ * must not be used by several threads at once.
+ */
+class BufferRing {
+  friend class BufferPoolManager;
+
+ public:
+  /**
+   * Creates a new BufferRing.
+   * @param ring_size the number of frames the scan recycles in each buffer pool instance
+   */
+  explicit BufferRing(size_t ring_size = SCAN_RING_SIZE) : ring_size_(ring_size) {}
+
+  /** @return the number of frames the scan recycles in each buffer pool instance */
+  size_t GetRingSize() const { return ring_size_; }
+
+ private:
+  /** A frame that the ring loaded a page into. */
+  struct Slot {
+    frame_id_t frame_id_;
+    page_id_t page_id_;
+  };
+
+  /** The frames used in one buffer pool instance. */
+  struct Ring {
+    std::vector<Slot> slots_;
+    /** The slot to recycle next once the ring is full. */
+    size_t next_{0};
+  };
+
+  size_t ring_size_;
+  std::unordered_map<const BufferPoolManager *, Ring> rings_;
+};
+
+}  // namespace bustub
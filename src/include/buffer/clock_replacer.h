@@ -45,8 +45,21 @@ class ClockReplacer : public Replacer {
 
   size_t Size() override;
 
+  void PeekVictims(size_t max_frames, std::vector<frame_id_t> *frames) override;
+
+  void Resize(size_t num_pages) override;
+
  private:
-  // TODO(student): implement me!
+  /** True for every frame that is currently in the replacer, indexed by frame id. */
+  std::vector<bool> in_replacer_;
+  /** Reference bit of every frame, indexed by frame id. */
+  std::vector<bool> ref_bits_;
+  /** Position of the clock hand. */
+  size_t clock_hand_{0};
+  /** Number of frames in the replacer. */
+  size_t size_{0};
+  /** Protects all of the above. */
+  std::mutex latch_;
 };
 
 }  // namespace bustub
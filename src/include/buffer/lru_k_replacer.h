@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.h
+//
+// Identification: src/include/buffer/lru_k_replacer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <mutex>  // NOLINT
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy (O'Neil et al., SIGMOD '93).
+ *
+ * Every Pin counts as a reference. The victim is the evictable frame whose K-th most recent reference lies furthest in
+ * the past; frames with fewer than K references have an infinite backward K-distance and are evicted first, oldest
+ * reference first. A frame touched once by a sequential scan is therefore evicted before a frame that has been used
+ * K times, no matter how recently the scan ran. SetEvictable holds or releases a frame without a reference: a page
+ * that was read ahead and not fetched yet has none, and is ordered among the other candidates by the time it was
+ * loaded.
+ *
+ * References that happen within the correlated reference period of the previous one (for example, the fetches of a
+ * single operation that pins the same page several times) are collapsed into one, and a frame is not chosen as a
+ * victim while its last reference is within that period unless no other frame is evictable. Time is measured in
+ * references seen by the replacer, so the period is a number of Pin calls.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k the number of references tracked per frame
+   * @param correlated_reference_period references closer than this to the previous one are treated as correlated
+   */
+  LRUKReplacer(size_t num_pages, size_t k, size_t correlated_reference_period = 0);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool evictable) override;
+
+  size_t Size() override;
+
+  void PeekVictims(size_t max_frames, std::vector<frame_id_t> *frames) override;
+
+  void Resize(size_t num_pages) override;
+
+  /** Drops the history of the frame's previous page, e.g. after it was deleted from the buffer pool. */
+  void RecordPage(frame_id_t frame_id, page_id_t page_id) override;
+
+ private:
+  /** Reference history of a frame. */
+  struct FrameHistory {
+    /** Uncorrelated reference times, most recent first, at most k_ entries. Empty until the first Pin. */
+    std::deque<size_t> history_;
+    /** Time of the last reference, correlated or not, or of the load of a page that was never referenced. */
+    size_t last_{0};
+    /** True if the frame is unpinned. */
+    bool evictable_{false};
+  };
+
+  /** Orders evictable frames: the frame with the smallest key is evicted first. */
+  using EvictionKey = std::tuple<bool, bool, size_t>;
+
+  /** @return the eviction key of frame at the current time */
+  EvictionKey GetEvictionKey(const FrameHistory &frame) const;
+
+  /** @return true if a reference at time is within the correlated reference period of the last one of frame */
+  bool IsCorrelated(const FrameHistory &frame, size_t time) const {
+    return time - frame.last_ < correlated_reference_period_;
+  }
+
+  /** Number of references tracked per frame. */
+  size_t k_;
+  /** Length of the correlated reference period. */
+  size_t correlated_reference_period_;
+  /** Logical clock, advanced on every reference. */
+  size_t current_time_{0};
+  /** Number of evictable frames. */
+  size_t evictable_count_{0};
+  /** History of every frame that was referenced since it was last victimized. */
+  std::unordered_map<frame_id_t, FrameHistory> frames_;
+  /** Protects all of the above. */
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -14,6 +14,7 @@
 
 #include <list>
 #include <mutex>  // NOLINT
+#include <unordered_map>
 #include <vector>
 
 #include "buffer/replacer.h"
@@ -45,8 +46,15 @@ class LRUReplacer : public Replacer {
 
   size_t Size() override;
 
+  void PeekVictims(size_t max_frames, std::vector<frame_id_t> *frames) override;
+
  private:
-  // TODO(student): implement me!
+  /** Unpinned frames, most recently unpinned at the front. */
+  std::list<frame_id_t> lru_list_;
+  /** Position of every unpinned frame in lru_list_. */
+  std::unordered_map<frame_id_t, std::list<frame_id_t>::iterator> lru_map_;
+  /** Protects lru_list_ and lru_map_. */
+  std::mutex latch_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,158 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_trace.h
+//
+// Identification: src/include/buffer/page_trace.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** The kind of a page access: a fetch of an existing page or the creation of a new one. */
+enum class PageAccessType : uint8_t { FETCH = 0, NEW = 1 };
+
+/** A single page access of a trace. */
+struct PageAccess {
+  page_id_t page_id_;
+  PageAccessType type_;
+};
+
+/**
+ * PageTraceWriter records page accesses into a compact binary trace file. The file starts with the 8 byte magic
+ * "BTTRACE1", followed by one varint per access: the zigzag encoded difference to the page id of the previous access,
+ * shifted left by one, with the access type in the lowest bit. A sequential scan therefore costs one byte per page.
+ * Records are buffered, and full buffers are written by a writer thread, so that Record never waits for the file.
+ * Record is thread safe.
+ */
+class PageTraceWriter {
+ public:
+  /**
+   * Creates a new trace file, replacing an existing one.
+   * @param file_name the name of the trace file
+   */
+  explicit PageTraceWriter(const std::string &file_name);
+
+  /** Writes the buffered records, stops the writer thread and closes the file. */
+  ~PageTraceWriter();
+
+  /**
+   * Appends an access to the trace.
+   * @param page_id id of the page accessed
+   * @param type the kind of access
+   */
+  void Record(page_id_t page_id, PageAccessType type);
+
+  /** Writes the buffered records to the file and waits until they are written. */
+  void Flush();
+
+  /** @return the number of accesses recorded so far */
+  size_t GetNumRecords();
+
+ private:
+  /** Queues the buffer for the writer thread and starts an empty one. The caller must hold latch_. */
+  void HandOffBuffer();
+
+  /** Body of the writer thread: writes the queued buffers in order until it is stopped. */
+  void RunWriter();
+
+  std::mutex latch_;
+  std::ofstream out_;
+  std::string buffer_;
+  page_id_t last_page_id_{0};
+  size_t num_records_{0};
+  /** Buffers waiting for the writer thread, oldest first. */
+  std::deque<std::string> full_buffers_;
+  /** True while the writer thread writes a buffer it took off full_buffers_. */
+  bool writing_{false};
+  bool stop_{false};
+  /** Signalled when a buffer is queued or the writer thread is stopped. */
+  std::condition_variable full_cv_;
+  /** Signalled when the writer thread has written a buffer. */
+  std::condition_variable written_cv_;
+  std::thread writer_;
+};
+
+/**
+ * PageTraceReader reads back the accesses of a trace file written by PageTraceWriter.
+ */
+class PageTraceReader {
+ public:
+  /**
+   * Opens a trace file.
+   * @param file_name the name of the trace file
+   * @throws Exception if the file cannot be opened or is not a page trace
+   */
+  explicit PageTraceReader(const std::string &file_name);
+
+  /**
+   * Reads the next access.
+   * @param[out] access the access
+   * @return false at the end of the trace, true otherwise
+   */
+  bool Next(PageAccess *access);
+
+  /**
+   * Reads a whole trace file.
+   * @param file_name the name of the trace file
+   * @return the accesses, in order
+   */
+  static std::vector<PageAccess> ReadAll(const std::string &file_name);
+
+ private:
+  std::ifstream in_;
+  page_id_t last_page_id_{0};
+};
+
+/**
+ * PageTraceGenerator produces synthetic traces of fetches, e.g. to compare replacement policies without a workload.
+ */
+class PageTraceGenerator {
+ public:
+  /**
+   * Accesses pages with a Zipfian distribution: the page of rank i is accessed with a probability proportional to
+   * 1 / (i + 1)^theta. The popular pages are spread over the page id space instead of being the lowest ids.
+   * @param num_pages the number of distinct pages
+   * @param num_accesses the length of the trace
+   * @param theta the skew, 0 for uniform accesses; 0.99 is the usual YCSB setting
+   * @param seed the seed of the random generator
+   */
+  static std::vector<PageAccess> Zipfian(size_t num_pages, size_t num_accesses, double theta, uint64_t seed = 0);
+
+  /**
+   * Accesses a hot set of pages uniformly, interrupted every scan_interval accesses by a sequential scan of
+   * scan_length pages that were not accessed before. The pages of the scans follow the hot set in the page id space.
+   * @param hot_pages the number of pages in the hot set
+   * @param scan_length the number of pages read by each scan
+   * @param scan_interval the number of hot set accesses between two scans
+   * @param num_accesses the length of the trace
+   * @param seed the seed of the random generator
+   */
+  static std::vector<PageAccess> Scan(size_t hot_pages, size_t scan_length, size_t scan_interval,
+                                      size_t num_accesses, uint64_t seed = 0);
+
+  /**
+   * Reads the same num_pages pages in a loop, in page id order. A pool smaller than the loop gets no hits under LRU.
+   * @param num_pages the number of pages in the loop
+   * @param num_accesses the length of the trace
+   */
+  static std::vector<PageAccess> Loop(size_t num_pages, size_t num_accesses);
+};
+
+}  // namespace bustub
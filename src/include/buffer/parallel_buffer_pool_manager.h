@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager shards the buffer pool into independent BufferPoolManager instances, each with its own
+ * latch, page table, free list and replacer. A page always lives in the instance selected by page_id % num_instances,
+ * so threads working on different pages rarely contend on the same latch.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManager instances
+   * @param pool_size the size of each instance
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            LogManager *log_manager = nullptr);
+
+  /**
+   * Destroys an existing ParallelBufferPoolManager and all of its instances.
+   */
+  ~ParallelBufferPoolManager() override;
+
+  /** @return nullptr, the frames are owned by the individual instances */
+  Page *GetPages() override { return nullptr; }
+
+  /** @return the total number of frames across all instances */
+  size_t GetPoolSize() override;
+
+  /**
+   * Spreads new_size frames evenly over the instances and resizes each of them.
+   * @param new_size the new total number of frames
+   */
+  void Resize(size_t new_size) override;
+
+  /** @return the sum of the counters of all instances */
+  BufferPoolStats GetStats() override;
+
+  void ResetStats() override;
+
+  /** Records the page accesses of all instances into a single trace file. */
+  void StartTrace(const std::string &file_name) override;
+
+  void StopTrace() override;
+
+  /** @return the number of instances */
+  size_t GetNumInstances() const { return num_instances_; }
+
+  /**
+   * @param page_id id of the page
+   * @return the instance responsible for page_id
+   */
+  BufferPoolManager *GetInstance(page_id_t page_id) {
+    return instances_[static_cast<size_t>(page_id) % num_instances_];
+  }
+
+ protected:
+  Page *FetchPageImpl(page_id_t page_id, BufferRing *ring = nullptr, bool reference = true) override;
+
+  bool UnpinPageImpl(page_id_t page_id, bool is_dirty) override;
+
+  Page *FetchChildPageImpl(Page *parent, int slot, page_id_t child_id) override;
+
+  bool UnpinPageImpl(Page *page, bool is_dirty) override;
+
+  bool FlushPageImpl(page_id_t page_id) override;
+
+  /**
+   * Creates a new page in one of the instances. The instances take turns, so consecutive new pages land on
+   * consecutive instances. The disk manager allocates an id that the chosen instance is responsible for; if that
+   * instance has every frame pinned, the id is deallocated again and the next instance is tried, each one once.
+   * @param[out] page_id id of created page
+   * @return nullptr if every instance is full, otherwise pointer to new page
+   */
+  Page *NewPageImpl(page_id_t *page_id) override;
+
+  bool DeletePageImpl(page_id_t page_id) override;
+
+  void DeletePageWhenUnpinnedImpl(page_id_t page_id) override;
+
+  void FlushAllPagesImpl() override;
+
+  /**
+   * Reads a page into the instance responsible for it. The prefetch threads belong to the parallel buffer pool, so a
+   * list of pages is followed across instances.
+   */
+  bool PrefetchPageImpl(page_id_t page_id, page_link_fn next_page, page_id_t *next_page_id) override;
+
+  void PrefetchBatchImpl(const std::vector<page_id_t> &page_ids) override;
+
+ private:
+  /** Number of instances. */
+  size_t num_instances_;
+  /** The instances, indexed by page_id % num_instances_. */
+  std::vector<BufferPoolManager *> instances_;
+  /** The instance the next NewPage tries first. */
+  std::atomic<size_t> next_instance_{0};
+};
+
+}  // namespace bustub
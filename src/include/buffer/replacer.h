@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
@@ -43,8 +45,49 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Marks a frame as evictable or not without counting it as a reference to its page. The buffer pool manager uses it
+   * while it holds a frame for its own work, such as reading a page ahead, writing it back or deleting it, so that
+   * only the fetches of its callers shape the replacement order. Policies that do not count references can keep the
+   * default, which maps it to Pin and Unpin.
+   * @param frame_id the id of the frame
+   * @param evictable true if the frame may be victimized again, false to hold it
+   */
+  virtual void SetEvictable(frame_id_t frame_id, bool evictable) {
+    if (evictable) {
+      Unpin(frame_id);
+    } else {
+      Pin(frame_id);
+    }
+  }
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
+
+  /**
+   * Tells the replacer that a frame now holds a different page. The buffer pool manager calls this whenever it loads
+   * a page into a frame, before pinning it; together with Victim it tells the replacer which page ids were evicted.
+   * Policies that only look at frames can ignore it.
+   * @param frame_id the id of the frame
+   * @param page_id the id of the page that the frame now holds
+   */
+  virtual void RecordPage(frame_id_t frame_id, page_id_t page_id) {}
+
+  /**
+   * Lists the frames that Victim would return next, in that order, without changing the replacer. The buffer pool
+   * uses it to clean the pages that are about to be evicted. Policies that cannot tell may leave frames empty.
+   * @param max_frames the maximum number of frames to list
+   * @param[out] frames the frames, next victim first
+   */
+  virtual void PeekVictims(size_t max_frames, std::vector<frame_id_t> *frames) {}
+
+  /**
+   * Tells the replacer that the buffer pool now has num_pages frames. When it shrinks, the frames past the new size
+   * have already been held and are never released again. Policies whose state does not depend on the number of
+   * frames can ignore it.
+   * @param num_pages the new number of frames
+   */
+  virtual void Resize(size_t num_pages) {}
 };
 
 }  // namespace bustub
@@ -27,14 +27,59 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** A committing transaction waits up to LOG_GROUP_COMMIT_WINDOW for others to share its log flush. */
+extern std::chrono::microseconds log_group_commit_window;
+
+/** The group commit window closes early once LOG_GROUP_COMMIT_BYTES bytes of log wait to be flushed. */
+extern std::atomic<size_t> log_group_commit_bytes;
+
+/** A new log is split into segments of LOG_SEGMENT_SIZE bytes; an existing log keeps the size it was created with. */
+extern std::atomic<size_t> log_segment_size;
+
+/**
+ * True if pages should carry a CRC-32C checksum, stamped on write and verified on read. Pages written while it is false
+ * carry none and are not verified.
+ */
+extern std::atomic<bool> enable_page_checksums;
+
+/** The page cleaner of a buffer pool wakes up every PAGE_CLEANER_INTERVAL. */
+extern std::chrono::milliseconds page_cleaner_interval;
+
+/** The page cleaner writes at most PAGE_CLEANER_MAX_PAGES pages per wake-up, which caps its write rate. */
+extern std::atomic<size_t> page_cleaner_max_pages;
+
+/**
+ * The page cleaner leaves up to PAGE_CLEANER_DIRTY_PERCENT percent of the frames of a buffer pool instance dirty and
+ * unpinned, and only writes back the pages beyond that which are closest to eviction.
+ */
+extern std::atomic<size_t> page_cleaner_dirty_percent;
+
 static constexpr int INVALID_PAGE_ID = -1;                                    // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                     // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                        // invalid log sequence number
+static constexpr int INVALID_FRAME_ID = -1;                                   // invalid frame id
 static constexpr int HEADER_PAGE_ID = 0;                                      // the header page id
-static constexpr int PAGE_SIZE = 4096;                                        // size of a data page in byte
+static constexpr int PAGE_SIZE = 4096;                                        // default size of a data page in byte
+static constexpr int MIN_PAGE_SIZE = 1024;                                    // smallest page size of a database file
+static constexpr int MAX_PAGE_SIZE = 65536;                                   // largest page size of a database file
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr int SCAN_RING_SIZE = 32;  // number of frames a sequential scan recycles per buffer pool instance
+static constexpr int PREFETCH_THREADS = 4;  // number of background threads serving prefetch requests
+static constexpr int READ_AHEAD_PAGES = 8;  // number of pages a scan asks the buffer pool to read ahead
+static constexpr int FLUSH_BATCH_PAGES = 256;  // number of pages FlushAllPages pins and writes at a time
+static constexpr int ASYNC_IO_QUEUE_DEPTH = 64;  // number of asynchronous I/Os a disk manager keeps in flight
+static constexpr int ASYNC_IO_THREADS = 16;  // number of threads serving asynchronous I/O where io_uring is missing
+static constexpr int PREFETCH_BATCH_PAGES = 32;  // number of listed pages a prefetch thread reads at a time
+static constexpr int DIRECT_IO_ALIGNMENT = 4096;  // alignment of the buffers and offsets of O_DIRECT I/O
+static constexpr size_t HUGE_PAGE_SIZE = 2 << 20;  // blocks of frames at least this large may use huge pages
+static constexpr int FILE_EXTENT_PAGES = 256;  // number of pages a database file grows by at a time
+static constexpr int TABLESPACE_STRIPE_PAGES = 4;  // number of adjacent page ids a tablespace keeps in one file
+static constexpr int PAGE_CHECKSUM_SIZE = 4;  // bytes at the end of every page that hold its checksum
+static constexpr int COMPRESSION_SLOT_SIZE = 512;  // granularity of the slots of a compressed database file
+static constexpr size_t LOG_RECYCLED_SEGMENTS = 4;  // number of released log segments kept for reuse
+static constexpr int LOG_READ_BUFFER_SIZE = 32 * LOG_BUFFER_SIZE;  // size of the buffer recovery reads the log with
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
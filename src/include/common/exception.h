@@ -45,6 +45,10 @@ enum class ExceptionType {
   INCOMPATIBLE_TYPE = 8,
   /** Method not implemented. */
   NOT_IMPLEMENTED = 11,
+  /** Out of memory error. */
+  OUT_OF_MEMORY = 12,
+  /** Data read from disk failed its checksum. */
+  CORRUPTION = 13,
 };
 
 class Exception : public std::runtime_error {
@@ -81,6 +85,10 @@ class Exception : public std::runtime_error {
         return "Incompatible type";
       case ExceptionType::NOT_IMPLEMENTED:
         return "Not implemented";
+      case ExceptionType::OUT_OF_MEMORY:
+        return "Out of Memory";
+      case ExceptionType::CORRUPTION:
+        return "Corruption";
       default:
         return "Unknown";
     }
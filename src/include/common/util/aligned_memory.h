@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aligned_memory.h
+//
+// Identification: src/include/common/util/aligned_memory.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace bustub {
+
+/** Frees a block allocated by AlignedMemory::Allocate, which needs to know its size. */
+struct AlignedMemoryDeleter {
+  size_t size_;
+  void operator()(char *data) const;
+};
+
+/** An owned block of memory aligned to DIRECT_IO_ALIGNMENT. */
+using AlignedBuffer = std::unique_ptr<char[], AlignedMemoryDeleter>;
+
+/**
+ * AlignedMemory allocates buffers that O_DIRECT reads and writes can use.
+ */
+class AlignedMemory {
+ public:
+  /**
+   * Allocates zeroed memory aligned to DIRECT_IO_ALIGNMENT. Blocks of at least HUGE_PAGE_SIZE are mapped from the OS
+   * and backed by transparent huge pages where the kernel allows it, which saves TLB misses on large buffer pools.
+   * @param size the size of the block in bytes
+   * @return the block
+   */
+  static AlignedBuffer Allocate(size_t size);
+
+  /** @return true if the address is aligned to DIRECT_IO_ALIGNMENT */
+  static bool IsAligned(const void *data);
+};
+
+}  // namespace bustub
@@ -0,0 +1,42 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// crc32c.h
+//
+// Identification: src/include/common/util/crc32c.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bustub {
+
+/**
+ * Crc32c computes the CRC-32C (Castagnoli) checksum, the one of iSCSI and ext4. On x86-64 CPUs with SSE4.2 it uses the
+ * crc32 instruction on three interleaved streams of 8 byte words, which hides the latency of the instruction; other
+ * CPUs get a slicing-by-8 table implementation.
+ */
+class Crc32c {
+ public:
+  /**
+   * @param data the bytes to checksum
+   * @param size the number of bytes
+   * @param crc the checksum of the bytes before data, to checksum a buffer in pieces
+   * @return the checksum of the bytes so far
+   */
+  static uint32_t Compute(const void *data, size_t size, uint32_t crc = 0);
+
+  /** Like Compute, but always with the table implementation. */
+  static uint32_t ComputeSoftware(const void *data, size_t size, uint32_t crc = 0);
+
+  /** @return true if Compute uses the crc32 instruction */
+  static bool HasHardwareSupport();
+};
+
+}  // namespace bustub
@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lz_codec.h
+//
+// Identification: src/include/common/util/lz_codec.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+namespace bustub {
+
+/**
+ * LZCodec is a small LZ77 compressor in the style of LZ4, fast enough to compress every page that is written. The
+ * output is a list of sequences, each a token byte, literals and a back reference:
+ *
+ *   | token (1) | extra literal length (0+) | literals | offset (2) | extra match length (0+) |
+ *
+ * The high nibble of the token is the number of literals, the low nibble the match length minus 4. A nibble of 15 is
+ * continued by extra length bytes, which are added up until one is below 255. The offset is the distance back to the
+ * match, little endian. The last sequence ends after its literals.
+ */
+class LZCodec {
+ public:
+  /**
+   * Compresses a buffer.
+   * @param src the bytes to compress
+   * @param size the number of bytes, at most 65536
+   * @param[out] dst the buffer for the compressed bytes
+   * @param capacity the size of dst
+   * @return the number of compressed bytes, 0 if they do not fit into capacity
+   */
+  static size_t Compress(const char *src, size_t size, char *dst, size_t capacity);
+
+  /**
+   * Decompresses a buffer. Corrupt input is detected as far as it would overflow either buffer.
+   * @param src the compressed bytes
+   * @param size the number of compressed bytes
+   * @param[out] dst the buffer for the decompressed bytes
+   * @param dst_size the number of bytes the input decompresses to
+   * @return true if the input decompressed to exactly dst_size bytes, false if it is corrupt
+   */
+  static bool Decompress(const char *src, size_t size, char *dst, size_t dst_size);
+};
+
+}  // namespace bustub
@@ -12,10 +12,12 @@
 
 #pragma once
 
+#include <memory>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "buffer/buffer_quota.h"
 #include "catalog/simple_catalog.h"
 #include "concurrency/transaction.h"
 #include "storage/page/tmp_tuple_page.h"
@@ -31,9 +33,15 @@ class ExecutorContext {
    * @param transaction the transaction executing the query
    * @param catalog the catalog that the executor should use
    * @param bpm the buffer pool manager that the executor should use
+   * @param buffer_quota_pages the number of frames the query may load pages into in each buffer pool instance before
+   * it recycles its own frames, 0 for no quota
    */
-  ExecutorContext(Transaction *transaction, SimpleCatalog *catalog, BufferPoolManager *bpm)
-      : transaction_(transaction), catalog_{catalog}, bpm_{bpm} {}
+  ExecutorContext(Transaction *transaction, SimpleCatalog *catalog, BufferPoolManager *bpm,
+                  size_t buffer_quota_pages = 0)
+      : transaction_(transaction),
+        catalog_{catalog},
+        bpm_{bpm},
+        buffer_quota_{buffer_quota_pages > 0 ? std::make_unique<BufferQuota>(buffer_quota_pages) : nullptr} {}
 
   DISALLOW_COPY_AND_MOVE(ExecutorContext);
 
@@ -48,6 +56,12 @@ class ExecutorContext {
   /** @return the buffer pool manager */
   BufferPoolManager *GetBufferPoolManager() { return bpm_; }
 
+  /**
+   * @return the buffer quota of the query, nullptr if it has none. Executors charge their page accesses to it by
+   * opening a BufferQuota::Scope in Init and Next.
+   */
+  BufferQuota *GetBufferQuota() { return buffer_quota_.get(); }
+
   /** @return the log manager - don't worry about it for now */
   LogManager *GetLogManager() { return nullptr; }
 
@@ -58,6 +72,7 @@ class ExecutorContext {
   Transaction *transaction_;
   SimpleCatalog *catalog_;
   BufferPoolManager *bpm_;
+  std::unique_ptr<BufferQuota> buffer_quota_;
 };
 
 }  // namespace bustub
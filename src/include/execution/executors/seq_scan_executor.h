@@ -12,11 +12,14 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
+#include "buffer/buffer_ring.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -42,5 +45,11 @@ class SeqScanExecutor : public AbstractExecutor {
  private:
   /** The sequential scan plan node to be executed. */
   const SeqScanPlanNode *plan_;
+  /** The table being scanned. */
+  TableMetadata *table_info_{nullptr};
+  /** The frames this scan recycles, so that it does not push the working set out of the buffer pool. */
+  BufferRing ring_;
+  /** The position of the scan. */
+  std::unique_ptr<TableIterator> iter_;
 };
 }  // namespace bustub
@@ -16,6 +16,7 @@
 #include <condition_variable>  // NOLINT
 #include <future>              // NOLINT
 #include <mutex>               // NOLINT
+#include <thread>              // NOLINT
 
 #include "recovery/log_record.h"
 #include "storage/disk/disk_manager.h"
@@ -25,6 +26,13 @@ namespace bustub {
 /**
  * LogManager maintains a separate thread that is awakened whenever the log buffer is full or whenever a timeout
  * happens. When the thread is awakened, the log buffer's content is written into the disk log file.
+ *
+ * Committing transactions share their log flushes (group commit): WaitForFlush hands the lsn of a commit record to
+ * the flush thread and sleeps. The thread waits up to log_group_commit_window, or until log_group_commit_bytes of log
+ * are buffered, for more commits to join, writes the whole buffer with a single fdatasync and wakes every transaction
+ * whose record is now durable. Records keep being appended to the second buffer while the first one is written.
+ * Without a window, a committing thread that finds neither a flush in progress nor other commits waiting writes the
+ * log itself; the commits that arrive during its write share the next flush of the flush thread.
  */
 class LogManager {
  public:
@@ -35,6 +43,7 @@ class LogManager {
   }
 
   ~LogManager() {
+    StopFlushThread();
     delete[] log_buffer_;
     delete[] flush_buffer_;
     log_buffer_ = nullptr;
@@ -46,13 +55,34 @@ class LogManager {
 
   lsn_t AppendLogRecord(LogRecord *log_record);
 
+  /**
+   * Blocks until a log record is durable, e.g. the commit record of a transaction. Without a flush thread or a group
+   * commit window, the calling thread flushes the log itself unless another flush is in progress.
+   * @param lsn the lsn of the log record
+   */
+  void WaitForFlush(lsn_t lsn);
+
+  /**
+   * Releases the log written so far, e.g. once a checkpoint has flushed every page it describes. The records that are
+   * still buffered are kept.
+   */
+  void TruncateLog();
+
   inline lsn_t GetNextLSN() { return next_lsn_; }
   inline lsn_t GetPersistentLSN() { return persistent_lsn_; }
   inline void SetPersistentLSN(lsn_t lsn) { persistent_lsn_ = lsn; }
   inline char *GetLogBuffer() { return log_buffer_; }
 
  private:
-  // TODO(students): you may add your own member variables
+  /** The loop of the flush thread. */
+  void FlushThread();
+  /** Makes the flush thread write the log buffer, or writes it in this thread if there is none, and waits for it. */
+  void RequestFlush(std::unique_lock<std::mutex> *lock);
+  /**
+   * Swaps the log buffers and writes the full one, after the flush in progress if there is one. latch_ is held by the
+   * caller and released during the write.
+   */
+  void FlushBuffer(std::unique_lock<std::mutex> *lock);
 
   /** The atomic counter which records the next log sequence number. */
   std::atomic<lsn_t> next_lsn_;
@@ -61,14 +91,30 @@ class LogManager {
 
   char *log_buffer_;
   char *flush_buffer_;
-
+  /** The number of bytes in log_buffer_. */
+  size_t offset_{0};
+  /** True while flush_buffer_ is being written. */
+  bool flushing_{false};
+  /** True if the log buffer is full and must be flushed without waiting for more commits. */
+  bool flush_requested_{false};
+  /** The highest lsn a committing transaction waits for. */
+  lsn_t wait_lsn_{INVALID_LSN};
+  /** The number of transactions waiting in WaitForFlush for a flush to finish. */
+  size_t num_waiters_{0};
+  /** True to make the flush thread write what is left and exit. */
+  bool stop_{false};
+
+  /** Guards the log buffers and the flush state above. */
   std::mutex latch_;
 
-  std::thread *flush_thread_ __attribute__((__unused__));
+  std::thread *flush_thread_{nullptr};
 
+  /** Wakes up the flush thread. */
   std::condition_variable cv_;
+  /** Wakes up the transactions and appenders that wait for a flush to finish. */
+  std::condition_variable flushed_cv_;
 
-  DiskManager *disk_manager_ __attribute__((__unused__));
+  DiskManager *disk_manager_;
 };
 
 }  // namespace bustub
@@ -28,8 +28,10 @@ namespace bustub {
 class LogRecovery {
  public:
   LogRecovery(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager)
-      : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), offset_(0) {
-    log_buffer_ = new char[LOG_BUFFER_SIZE];
+      : disk_manager_(disk_manager),
+        buffer_pool_manager_(buffer_pool_manager),
+        offset_(disk_manager->GetLogBegin()) {
+    log_buffer_ = new char[LOG_READ_BUFFER_SIZE];
   }
 
   ~LogRecovery() {
@@ -47,10 +49,11 @@ class LogRecovery {
 
   /** Maintain active transactions and its corresponding latest lsn. */
   std::unordered_map<txn_id_t, lsn_t> active_txn_;
-  /** Mapping the log sequence number to log file offset for undos. */
-  std::unordered_map<lsn_t, int> lsn_mapping_;
+  /** Mapping the log sequence number to log offset for undos. */
+  std::unordered_map<lsn_t, int64_t> lsn_mapping_;
 
-  int offset_ __attribute__((__unused__));
+  /** The log is read from the beginning of the log that checkpoints kept, LOG_READ_BUFFER_SIZE bytes at a time. */
+  int64_t offset_ __attribute__((__unused__));
   char *log_buffer_;
 };
 
@@ -0,0 +1,182 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_disk_io.h
+//
+// Identification: src/include/storage/disk/async_disk_io.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <deque>
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace bustub {
+
+/**
+ * A read or write of a list of buffers at a file offset, submitted to an AsyncDiskIO.
+ */
+struct AsyncIORequest {
+  bool write_;
+  int fd_;
+  std::vector<struct iovec> iov_;
+  off_t offset_;
+  std::promise<bool> done_;
+
+  /**
+   * Finishes the request with blocking preadv/pwritev, starting after the first transferred bytes. A read that reaches
+   * the end of the file fills the rest of its buffers with zeros, like DiskManager::ReadPage.
+   * @param transferred the number of bytes already transferred
+   * @return false on an I/O error, true otherwise
+   */
+  bool Complete(size_t transferred);
+};
+
+/**
+ * AsyncDiskIO runs reads and writes in the background so that a few threads can keep many I/Os in flight. Submit
+ * returns at once with a future that is ready when the I/O is done. The buffers must stay valid until then.
+ */
+class AsyncDiskIO {
+ public:
+  virtual ~AsyncDiskIO() = default;
+
+  /**
+   * Starts a read of consecutive bytes of a file into a list of buffers.
+   * @param fd the file descriptor
+   * @param iov the buffers
+   * @param offset the file offset of the first byte
+   * @return a future that is true when the read succeeded, false on an I/O error
+   */
+  std::future<bool> Read(int fd, std::vector<struct iovec> iov, off_t offset) {
+    return Submit(false, fd, std::move(iov), offset);
+  }
+
+  /**
+   * Starts a write of a list of buffers to consecutive bytes of a file.
+   * @param fd the file descriptor
+   * @param iov the buffers
+   * @param offset the file offset of the first byte
+   * @return a future that is true when the write succeeded, false on an I/O error
+   */
+  std::future<bool> Write(int fd, std::vector<struct iovec> iov, off_t offset) {
+    return Submit(true, fd, std::move(iov), offset);
+  }
+
+  /** @return the name of the backend */
+  virtual const char *GetName() const = 0;
+
+  /**
+   * Creates the best backend the kernel supports: io_uring, or else a pool of at most ASYNC_IO_THREADS threads running
+   * blocking I/O.
+   * @param queue_depth the number of I/Os that may be in flight at once
+   * @param use_io_uring false to use the thread pool even if io_uring is available
+   */
+  static std::unique_ptr<AsyncDiskIO> Create(size_t queue_depth, bool use_io_uring = true);
+
+ protected:
+  virtual std::future<bool> Submit(bool write, int fd, std::vector<struct iovec> iov, off_t offset) = 0;
+};
+
+/**
+ * IoUringDiskIO submits every request to an io_uring as one readv or writev. A completion thread reaps the results;
+ * the rare short transfer is finished by that thread with blocking I/O. At most queue_depth requests are in flight,
+ * further submitters wait for a completion.
+ */
+class IoUringDiskIO : public AsyncDiskIO {
+ public:
+  /**
+   * Sets up an io_uring.
+   * @param queue_depth the number of I/Os that may be in flight at once
+   * @throws Exception if the kernel does not support io_uring
+   */
+  explicit IoUringDiskIO(size_t queue_depth);
+
+  /** Waits for the I/Os in flight and tears down the ring. */
+  ~IoUringDiskIO() override;
+
+  DISALLOW_COPY_AND_MOVE(IoUringDiskIO);
+
+  const char *GetName() const override { return "io_uring"; }
+
+ protected:
+  std::future<bool> Submit(bool write, int fd, std::vector<struct iovec> iov, off_t offset) override;
+
+ private:
+  /** Adds a request to the submission queue and tells the kernel. user_data 0 stops the completion thread. */
+  void Enqueue(uint8_t opcode, AsyncIORequest *request);
+
+  /** Reaps completions until a stop request completes. */
+  void RunCompletionThread();
+
+  int ring_fd_{-1};
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  struct io_uring_sqe *sqes_{nullptr};
+  size_t sqes_size_{0};
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  struct io_uring_cqe *cqes_{nullptr};
+
+  size_t queue_depth_;
+  /** Guards the submission queue and in_flight_. */
+  std::mutex latch_;
+  std::condition_variable slot_cv_;
+  size_t in_flight_{0};
+  std::thread completion_thread_;
+};
+
+/**
+ * ThreadPoolDiskIO is the fallback for kernels without io_uring: a pool of threads serves the requests with blocking
+ * preadv/pwritev, one request per thread at a time.
+ */
+class ThreadPoolDiskIO : public AsyncDiskIO {
+ public:
+  /** @param num_threads the number of I/Os that may be in flight at once */
+  explicit ThreadPoolDiskIO(size_t num_threads);
+
+  /** Finishes the queued requests and stops the threads. */
+  ~ThreadPoolDiskIO() override;
+
+  DISALLOW_COPY_AND_MOVE(ThreadPoolDiskIO);
+
+  const char *GetName() const override { return "thread pool"; }
+
+ protected:
+  std::future<bool> Submit(bool write, int fd, std::vector<struct iovec> iov, off_t offset) override;
+
+ private:
+  void RunWorker();
+
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::deque<std::unique_ptr<AsyncIORequest>> queue_;
+  bool stop_{false};
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace bustub
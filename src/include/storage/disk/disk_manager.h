@@ -13,83 +13,215 @@
 #pragma once
 
 #include <atomic>
-#include <fstream>
+#include <deque>
 #include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
+#include "storage/disk/async_disk_io.h"
+#include "storage/disk/page_extent_map.h"
 
 namespace bustub {
 
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ * Pages are read and written with positional I/O on one file descriptor, so any number of threads may read and write
+ * pages at the same time without a latch. ReadPageAsync and WritePageAsync keep up to ASYNC_IO_QUEUE_DEPTH page I/Os
+ * in flight through io_uring, or through a thread pool on kernels without it.
+ *
+ * Which pages are allocated is tracked in a bitmap that is kept in the pages of a map file next to the database file
+ * (test.db has test.fsm). AllocatePage hands out the lowest free page id, so deallocated pages are reused before the
+ * file grows, and the file grows by FILE_EXTENT_PAGES pages at a time through fallocate. The bitmap is written to disk
+ * by SyncPages and ShutDown, so that a checkpoint covers the pages and their allocation alike.
+ *
+ * The last PAGE_CHECKSUM_SIZE bytes of every page are reserved for a CRC-32C checksum of the rest of the page. While
+ * enable_page_checksums is set, the write calls stamp it into the page data and the read calls verify it. A page with
+ * an empty checksum, e.g. one written while checksums were off, is not verified.
+ *
+ * A database file may be compressed. Its pages are then compressed with LZCodec on write and stored in slots of
+ * variable size, which a PageExtentMap in a map file next to the database file (test.db has test.pmap) keeps track of.
+ * Pages that do not compress by at least COMPRESSION_SLOT_SIZE bytes are stored as they are. The asynchronous calls
+ * of a compressed file run synchronously.
+ *
+ * A database may also be a tablespace of several files, e.g. on different devices. Its pages are striped across the
+ * files in runs of TABLESPACE_STRIPE_PAGES pages, so that scans and checkpoints keep all of them busy. Every file has
+ * its own descriptor and asynchronous I/O queue. The log and the map files are named after the first file, and a
+ * tablespace must always be opened with the same files in the same order.
+ *
+ * The log is split into segment files of log_segment_size bytes, named after a manifest file (test.log has
+ * test.log.0, test.log.1, ...). Log offsets run on across the segments, and the manifest records the size of the
+ * segments, the offset the log begins at and the last segment. TruncateLog releases the segments a checkpoint no
+ * longer needs; up to LOG_RECYCLED_SEGMENTS of them are zeroed and kept as preallocated files that later segments
+ * reuse, and the rest are removed, so the log takes up a bounded amount of disk while it is written and truncated.
+ * Segments are zeroed before they join the log, so that after a crash the end of the log is found by following the
+ * sizes at the start of its records from the last end the manifest recorded.
+ *
+ * The page and log calls are virtual, so that DiskManager is also the interface of the backends that stand in for
+ * the files: DiskManagerMemory keeps the pages and the log in memory, and DiskManagerLatency adds the service times of
+ * a modeled device to another backend. Whatever takes a DiskManager runs on any of them.
  */
 class DiskManager {
  public:
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param page_size the size of the pages of the file, a power of two between MIN_PAGE_SIZE and MAX_PAGE_SIZE; a file
+   * keeps the page size it was created with
+   * @param direct_io true to open the database file with O_DIRECT, so that pages bypass the OS page cache instead of
+   * being cached twice. The page buffers of the asynchronous and batched calls must then be aligned to
+   * DIRECT_IO_ALIGNMENT, as the frames of a buffer pool are; ReadPage and WritePage accept any buffer.
+   * @param compress true to compress the pages of the file; a file keeps being compressed or not as it was created.
+   * Compressed pages are not aligned on disk, so compression cannot be combined with direct_io.
+   * @throws Exception if the file cannot be opened, e.g. O_DIRECT on a file system that does not support it
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, size_t page_size = PAGE_SIZE, bool direct_io = false,
+                       bool compress = false)
+      : DiskManager(std::vector<std::string>{db_file}, page_size, direct_io, compress) {}
 
-  ~DiskManager() = default;
+  /**
+   * Creates a new disk manager that stripes the pages across the files of a tablespace.
+   * @param db_files the file names of the database files, at least one; a compressed tablespace has exactly one
+   * @see DiskManager(const std::string &, size_t, bool, bool) for the other parameters
+   */
+  explicit DiskManager(const std::vector<std::string> &db_files, size_t page_size = PAGE_SIZE, bool direct_io = false,
+                       bool compress = false);
+
+  virtual ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
    */
-  void ShutDown();
+  virtual void ShutDown();
+
+  /**
+   * Write a page to the database file. With checksums on, the checksum is stamped into the trailer of page_data.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  virtual void WritePage(page_id_t page_id, const char *page_data);
+
+  /**
+   * Writes a batch of pages to the database file. The pages are sorted by page id and every run of adjacent pages is
+   * written with a single vectored write. The page data must stay unchanged until the call returns.
+   * @param pages the ids and raw data of the pages, in any order; sorted by page id on return
+   */
+  virtual void WritePages(std::vector<std::pair<page_id_t, const char *>> *pages);
 
   /**
-   * Write a page to the database file.
+   * Starts writing a page to the database file and returns at once. The page data must stay unchanged until the
+   * returned future is ready. Writes that overlap in time must be to different pages.
    * @param page_id id of the page
    * @param page_data raw page data
+   * @return a future that is true when the page is written, false on an I/O error
    */
-  void WritePage(page_id_t page_id, const char *page_data);
+  virtual std::future<bool> WritePageAsync(page_id_t page_id, const char *page_data);
+
+  /**
+   * Makes every page written so far durable.
+   */
+  virtual void SyncPages();
 
   /**
    * Read a page from the database file.
    * @param page_id id of the page
    * @param[out] page_data output buffer
+   * @throws Exception of type CORRUPTION if the page does not match its checksum
+   */
+  virtual void ReadPage(page_id_t page_id, char *page_data);
+
+  /**
+   * Starts reading a page from the database file and returns at once. A page beyond the end of the file reads as
+   * zeros, like with ReadPage.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer, which must stay valid until the returned future is ready
+   * @return a future that is true when the page is read, false on an I/O error or if the page does not match its
+   * checksum
    */
-  void ReadPage(page_id_t page_id, char *page_data);
+  virtual std::future<bool> ReadPageAsync(page_id_t page_id, char *page_data);
+
+  /** @return the name of the backend of the asynchronous page I/O, e.g. "io_uring" or "thread pool" */
+  virtual const char *GetAsyncBackend() { return AsyncIO(0)->GetName(); }
 
   /**
-   * Flush the entire log buffer into disk.
+   * Flush the entire log buffer into disk, with one fdatasync per segment it spans. Only one thread may write the log.
    * @param log_data raw log data
    * @param size size of log entry
    */
-  void WriteLog(char *log_data, int size);
+  virtual void WriteLog(char *log_data, int size);
 
   /**
    * Read a log entry from the log file.
    * @param[out] log_data output buffer
    * @param size size of the log entry
-   * @param offset offset of the log entry in the file
-   * @return true if the read was successful, false otherwise
+   * @param offset offset of the log entry in the log
+   * @return true if the read was successful, false otherwise, e.g. at the end of the log or before its beginning
+   */
+  virtual bool ReadLog(char *log_data, int size, int64_t offset);
+
+  /**
+   * Releases the log before an offset, e.g. the redo point of a checkpoint, which can no longer be read afterwards.
+   * @param offset the offset of the first log record that is still needed
+   */
+  virtual void TruncateLog(int64_t offset);
+
+  /** @return the offset of the first log byte that has not been truncated, where recovery starts reading */
+  virtual int64_t GetLogBegin() const { return log_begin_; }
+
+  /** @return the offset of the end of the log */
+  virtual int64_t GetLogSize() const { return log_size_; }
+
+  /**
+   * Allocate a page on disk, reusing the lowest deallocated page id if there is one.
+   * @return the id of the allocated page
    */
-  bool ReadLog(char *log_data, int size, int offset);
+  virtual page_id_t AllocatePage();
 
   /**
-   * Allocate a page on disk.
+   * Allocate a page on disk whose id leaves the given remainder, reusing the lowest such deallocated page id if there
+   * is one. A parallel buffer pool uses it to create a page in a chosen instance.
+   * @param modulus the number the page id is divided by
+   * @param remainder the remainder of the page id, less than modulus
    * @return the id of the allocated page
    */
-  page_id_t AllocatePage();
+  virtual page_id_t AllocatePage(size_t modulus, size_t remainder);
 
   /**
-   * Deallocate a page on disk.
+   * Deallocate a page on disk. Its id is handed out again by a later AllocatePage.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(page_id_t page_id);
+  virtual void DeallocatePage(page_id_t page_id);
+
+  /** @return true if the page is allocated */
+  virtual bool IsPageAllocated(page_id_t page_id);
+
+  /** @return true if the database file was opened with O_DIRECT */
+  virtual bool IsDirectIO() const { return direct_io_; }
+
+  /** @return true if the pages of the database file are compressed */
+  virtual bool IsCompressed() const { return extent_map_ != nullptr; }
+
+  /** @return the number of files the pages are striped across */
+  virtual size_t GetNumFiles() const { return db_fds_.size(); }
+
+  /** @return the size of the pages of the database file */
+  size_t GetPageSize() const { return page_size_; }
 
   /** @return the number of disk flushes */
-  int GetNumFlushes() const;
+  virtual int GetNumFlushes() const;
 
   /** @return true iff the in-memory content has not been flushed yet */
   bool GetFlushState() const;
 
   /** @return the number of disk writes */
-  int GetNumWrites() const;
+  virtual int GetNumWrites() const;
+
+  /** @return the number of pages read that did not match their checksum */
+  virtual int GetNumChecksumFailures() const { return num_checksum_failures_; }
 
   /**
    * Sets the future which is used to check for non-blocking flushes.
@@ -100,19 +232,84 @@ class DiskManager {
   /** Checks if the non-blocking flush future was set. */
   inline bool HasFlushLogFuture() { return flush_log_f_ != nullptr; }
 
+ protected:
+  /**
+   * Creates a disk manager without files, for the backends that keep the pages elsewhere.
+   * @param page_size the size of the pages, a power of two between MIN_PAGE_SIZE and MAX_PAGE_SIZE
+   */
+  explicit DiskManager(size_t page_size);
+
+  /** Stamps the checksum of a page into its trailer if checksums are on. */
+  void StampChecksum(const char *page_data);
+  /** @return false if checksums are on and the page does not match its checksum */
+  bool VerifyChecksum(page_id_t page_id, const char *page_data);
+
+  size_t page_size_;
+  std::atomic<int> num_flushes_{0};
+  std::atomic<int> num_writes_{0};
+  std::atomic<int> num_checksum_failures_{0};
+  std::atomic<int64_t> log_begin_{0};
+  std::atomic<int64_t> log_size_{0};
+
  private:
-  int GetFileSize(const std::string &file_name);
-  // stream to write log file
-  std::fstream log_io_;
+  int64_t GetFileSize(const std::string &file_name);
+  /** Writes the pages of the allocation map that changed since the last call to the map file. */
+  void WriteAllocationMap();
+  /** @return the backend of the asynchronous page I/O of a file, which is set up by the first asynchronous call */
+  AsyncDiskIO *AsyncIO(size_t file);
+  /** @return the index of the file that holds a page, with the offset of the page in it */
+  size_t Locate(page_id_t page_id, off_t *offset) const;
+  /** Compresses a page and writes it to its slot. */
+  void WriteCompressedPage(page_id_t page_id, const char *page_data);
+  /** Reads a page from its slot and decompresses it. @return false on an I/O error */
+  bool ReadCompressedPage(page_id_t page_id, char *page_data);
+  /** Opens the segments the log manifest lists, or starts an empty log if there is no manifest yet. */
+  void OpenLog();
+  /** Writes the manifest and closes the log. */
+  void CloseLog();
+  /** Makes the log manifest, starting at first_segment, durable. The caller must hold log_latch_. */
+  void WriteLogManifest(int64_t first_segment);
+  /** Adds a segment to the end of the log, reusing a recycled file if there is one. The caller must hold log_latch_. */
+  void AddLogSegment();
+  /** @return the name of the file of a log segment */
+  std::string LogSegmentName(int64_t segment) const;
+  /** Reads or writes log bytes, which may span segments. The caller must hold log_latch_. @return false on error */
+  bool AccessLog(char *log_data, size_t size, int64_t offset, bool write);
+
+  // descriptor of the log manifest, which is rewritten with pwrite
+  int log_fd_{-1};
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
+  // guards the log segments below
+  std::mutex log_latch_;
+  int64_t log_segment_size_{0};
+  // descriptors of the segments from the one log_begin_ is in to the last, which are written with pwrite
+  std::deque<int> log_segments_;
+  int64_t log_first_segment_{0};
+  // the numbers of the released segment files that wait to be reused, in order and all beyond the last segment
+  std::vector<int64_t> recycled_segments_;
+  // descriptors of the db files, only used with pread and pwrite so that concurrent page I/O needs no latch
+  std::vector<int> db_fds_;
+  // one asynchronous I/O queue per db file
+  std::vector<std::unique_ptr<AsyncDiskIO>> async_io_;
+  std::once_flag async_io_once_;
   std::string file_name_;
-  std::atomic<page_id_t> next_page_id_;
-  int num_flushes_;
-  int num_writes_;
-  bool flush_log_;
-  std::future<void> *flush_log_f_;
+  bool direct_io_{false};
+  // the slots of the pages of a compressed db file, nullptr if the file is not compressed
+  std::unique_ptr<PageExtentMap> extent_map_;
+  // descriptor of the map file that holds the allocation bitmap
+  int fsm_fd_{-1};
+  // guards the allocation bitmap and the file size below
+  std::mutex allocation_latch_;
+  // one bit per page id, set if the page is allocated; page_size_ bytes of it make up one page of the map file
+  std::vector<uint64_t> allocation_map_;
+  // whether each page of the map changed since it was last written
+  std::vector<bool> dirty_map_pages_;
+  // no page id below this one is free
+  page_id_t first_free_hint_{0};
+  // the number of pages the db files have room for, together
+  page_id_t file_pages_{0};
+  bool flush_log_{false};
+  std::future<void> *flush_log_f_{nullptr};
 };
 
 }  // namespace bustub
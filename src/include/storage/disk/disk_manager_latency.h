@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_latency.h
+//
+// Identification: src/include/storage/disk/disk_manager_latency.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
+#include <utility>
+#include <vector>
+
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/** The service times of a modeled storage device. */
+struct DiskLatencyModel {
+  /** The time from issuing a read to the first byte, e.g. seek and rotation or flash access. */
+  std::chrono::microseconds read_latency_{0};
+  /** Likewise for a write. */
+  std::chrono::microseconds write_latency_{0};
+  /** The time to make the writes before a sync durable. */
+  std::chrono::microseconds sync_latency_{0};
+  /** The bytes per second all requests share for their transfers; 0 for no limit. */
+  uint64_t bandwidth_{0};
+  /** The number of requests the device serves at the same time, e.g. 1 for a disk arm. */
+  size_t queue_depth_{1};
+
+  /** @return a datacenter NVMe SSD: 100 us reads, 30 us buffered writes, 2 GB/s at a queue depth of 32 */
+  static DiskLatencyModel Ssd();
+
+  /** @return a 7200 rpm hard disk: 8 ms to seek and rotate, 150 MB/s, one request at a time */
+  static DiskLatencyModel Hdd();
+};
+
+/**
+ * DiskManagerLatency wraps another backend and makes every call take as long as it would on a modeled device, so that
+ * benchmarks reproduce the behavior of an SSD or a hard disk on any machine. Put it over a DiskManagerMemory to take
+ * the disk of the machine out of the measurement altogether.
+ *
+ * A request occupies one of queue_depth_ slots of the device for its latency, then transfers its bytes at the shared
+ * bandwidth. A batch of pages pays the latency once per run of adjacent pages, like the vectored writes of the file
+ * backend. The asynchronous calls return at once and their futures become ready when the request would complete, so
+ * requests in flight overlap as on the device. Times are accurate to the resolution of sleeping, tens of microseconds.
+ */
+class DiskManagerLatency : public DiskManager {
+ public:
+  /**
+   * Creates a disk manager that delays the calls to a backend.
+   * @param backend the disk manager that stores the pages, which must outlive this one
+   * @param model the device to model
+   */
+  DiskManagerLatency(DiskManager *backend, const DiskLatencyModel &model);
+
+  ~DiskManagerLatency() override = default;
+
+  void ShutDown() override { backend_->ShutDown(); }
+  void WritePage(page_id_t page_id, const char *page_data) override;
+  void WritePages(std::vector<std::pair<page_id_t, const char *>> *pages) override;
+  std::future<bool> WritePageAsync(page_id_t page_id, const char *page_data) override;
+  void SyncPages() override;
+  void ReadPage(page_id_t page_id, char *page_data) override;
+  std::future<bool> ReadPageAsync(page_id_t page_id, char *page_data) override;
+  const char *GetAsyncBackend() override { return backend_->GetAsyncBackend(); }
+  void WriteLog(char *log_data, int size) override;
+  bool ReadLog(char *log_data, int size, int64_t offset) override;
+  void TruncateLog(int64_t offset) override { backend_->TruncateLog(offset); }
+  int64_t GetLogBegin() const override { return backend_->GetLogBegin(); }
+  int64_t GetLogSize() const override { return backend_->GetLogSize(); }
+  page_id_t AllocatePage() override { return backend_->AllocatePage(); }
+  page_id_t AllocatePage(size_t modulus, size_t remainder) override {
+    return backend_->AllocatePage(modulus, remainder);
+  }
+  void DeallocatePage(page_id_t page_id) override { backend_->DeallocatePage(page_id); }
+  bool IsPageAllocated(page_id_t page_id) override { return backend_->IsPageAllocated(page_id); }
+  bool IsDirectIO() const override { return backend_->IsDirectIO(); }
+  bool IsCompressed() const override { return backend_->IsCompressed(); }
+  size_t GetNumFiles() const override { return backend_->GetNumFiles(); }
+  int GetNumFlushes() const override { return backend_->GetNumFlushes(); }
+  int GetNumWrites() const override { return backend_->GetNumWrites(); }
+  int GetNumChecksumFailures() const override { return backend_->GetNumChecksumFailures(); }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * Books a request on the device.
+   * @param latency the latency of the request
+   * @param bytes the number of bytes it transfers
+   * @param barrier true to start after every request booked before, as a sync does
+   * @return the time the request completes
+   */
+  Clock::time_point Schedule(std::chrono::microseconds latency, size_t bytes, bool barrier = false);
+
+  DiskManager *backend_;
+  DiskLatencyModel model_;
+  /** Guards the bookings below. */
+  std::mutex latch_;
+  /** The time each slot of the device is busy until. */
+  std::vector<Clock::time_point> busy_until_;
+  /** The time the transfers booked so far end. */
+  Clock::time_point transfer_until_;
+};
+
+}  // namespace bustub
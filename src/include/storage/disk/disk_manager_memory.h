@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_memory.h
+//
+// Identification: src/include/storage/disk/disk_manager_memory.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>         // NOLINT
+#include <shared_mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerMemory keeps the pages and the log of a database in memory, so that tests and benchmarks do not depend on
+ * the disk of the machine. Everything is lost with the disk manager.
+ *
+ * The pages are stored in chunks of MEMORY_CHUNK_PAGES pages, which are allocated when one of their pages is first
+ * written; a page that was never written reads as zeros, like one past the end of a database file. Pages are copied
+ * under latches striped by page id, so threads that read and write different pages rarely wait for each other. The
+ * asynchronous calls complete before they return, and checksums are stamped and verified as by the file backend.
+ */
+class DiskManagerMemory : public DiskManager {
+ public:
+  /**
+   * Creates an empty in-memory database.
+   * @param page_size the size of the pages, a power of two between MIN_PAGE_SIZE and MAX_PAGE_SIZE
+   */
+  explicit DiskManagerMemory(size_t page_size = PAGE_SIZE);
+
+  ~DiskManagerMemory() override = default;
+
+  void ShutDown() override {}
+  void WritePage(page_id_t page_id, const char *page_data) override;
+  void WritePages(std::vector<std::pair<page_id_t, const char *>> *pages) override;
+  std::future<bool> WritePageAsync(page_id_t page_id, const char *page_data) override;
+  void SyncPages() override {}
+  void ReadPage(page_id_t page_id, char *page_data) override;
+  std::future<bool> ReadPageAsync(page_id_t page_id, char *page_data) override;
+  const char *GetAsyncBackend() override { return "memory"; }
+  void WriteLog(char *log_data, int size) override;
+  bool ReadLog(char *log_data, int size, int64_t offset) override;
+  void TruncateLog(int64_t offset) override;
+
+ private:
+  static constexpr size_t MEMORY_CHUNK_PAGES = 1024;
+  static constexpr size_t NUM_PAGE_LATCHES = 64;
+
+  /** @return the memory of a page, nullptr if its chunk was never written and create is false */
+  char *GetPage(page_id_t page_id, bool create);
+
+  /** Guards the list of chunks; the chunks themselves never move. */
+  std::shared_mutex chunks_latch_;
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  /** A page is copied in or out under the latch of its page id modulo NUM_PAGE_LATCHES. */
+  std::array<std::mutex, NUM_PAGE_LATCHES> page_latches_;
+  std::mutex log_latch_;
+  /** The log from log_begin_ on. */
+  std::vector<char> log_;
+};
+
+}  // namespace bustub
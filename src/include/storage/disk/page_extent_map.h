@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_extent_map.h
+//
+// Identification: src/include/storage/disk/page_extent_map.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** Where a page of a compressed database file is stored. */
+struct PageExtent {
+  /** The file offset of the slot that holds the page. */
+  uint64_t offset_;
+  /** The size of the slot, a multiple of COMPRESSION_SLOT_SIZE; 0 if the page was never written. */
+  uint32_t capacity_;
+  /** 1 if the slot holds the page uncompressed, 0 if compressed. */
+  uint32_t raw_;
+};
+
+/**
+ * PageExtentMap places the pages of a compressed database file in slots of variable size and remembers which slot
+ * holds which page. The map is kept in a map file next to the database file, one PageExtent per page id.
+ *
+ * A page is rewritten in place as long as it fits its slot; otherwise it moves to a free slot of the right size or to
+ * the end of the file. The slot it leaves is reused only after the map that no longer refers to it is durable, so the
+ * map on disk always points to slots that still hold the pages as of the last Sync. The free slots are not kept on
+ * disk, they are the gaps between the slots of the map.
+ */
+class PageExtentMap {
+ public:
+  /**
+   * Opens a map file, creating it if it does not exist.
+   * @param file_name the name of the map file
+   * @param page_size the size of the pages of the database file
+   * @param truncate true to start with an empty map, e.g. because the database file is new
+   * @throws Exception if the file cannot be opened or read
+   */
+  PageExtentMap(const std::string &file_name, size_t page_size, bool truncate);
+
+  /** Writes the changes to the map and closes the map file. */
+  ~PageExtentMap();
+
+  /**
+   * Looks up the slot of a page.
+   * @param page_id id of the page
+   * @param[out] extent the slot of the page
+   * @return false if the page was never written
+   */
+  bool Find(page_id_t page_id, PageExtent *extent);
+
+  /**
+   * Finds the slot a page is written to.
+   * @param page_id id of the page
+   * @param size the number of bytes to write, at most the page size
+   * @param raw true if the page is written uncompressed
+   * @return the slot of the page from now on
+   */
+  PageExtent Place(page_id_t page_id, size_t size, bool raw);
+
+  /**
+   * Forgets a page. Its slot is reused after the next Sync.
+   * @param page_id id of the page
+   */
+  void Remove(page_id_t page_id);
+
+  /** Makes the map durable and lets the slots that pages left be reused. */
+  void Sync();
+
+  /** @return the number of bytes of the database file taken up by slots, in use or free */
+  uint64_t GetFileSize();
+
+ private:
+  /** Writes the pages of the map that changed since the last call to the map file. The caller must hold latch_. */
+  void WriteMap();
+
+  int fd_{-1};
+  size_t page_size_;
+  /** Guards the map and the free slots. */
+  std::mutex latch_;
+  /** One extent per page id; page_size_ bytes of it make up one page of the map file. */
+  std::vector<PageExtent> extents_;
+  /** Whether each page of the map changed since it was last written. */
+  std::vector<bool> dirty_map_pages_;
+  /** The offsets of the free slots, by their size in COMPRESSION_SLOT_SIZE units. */
+  std::vector<std::vector<uint64_t>> free_slots_;
+  /** The slots that pages left since the last Sync, as offset and capacity. */
+  std::vector<std::pair<uint64_t, uint32_t>> left_slots_;
+  /** The end of the last slot. */
+  uint64_t file_end_{0};
+};
+
+}  // namespace bustub
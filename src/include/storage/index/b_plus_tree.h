@@ -10,10 +10,12 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
 #include <queue>
 #include <string>
 #include <vector>
 
+#include "common/rwlatch.h"
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_internal_page.h"
@@ -23,6 +25,9 @@ namespace bustub {
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 
+/** The kind of access a traversal of the tree is made for; it decides which latches are taken and kept. */
+enum class Operation { FIND, INSERT, DELETE };
+
 /**
  * Main class providing the API for the Interactive B+ Tree.
  *
@@ -32,6 +37,13 @@ namespace bustub {
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ *
+ * Concurrent access uses latch crabbing for writers: they keep the write
+ * latches of every page that may still change (the transaction page set, where
+ * nullptr stands for root_latch_) until they reach a page that is safe for the
+ * operation. Readers take no latch on internal pages; they read them
+ * optimistically and start over when a writer got in between. Only the leaf
+ * is read latched.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
@@ -39,8 +51,9 @@ class BPlusTree {
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
 
  public:
+  // A max size of 0 makes the nodes fill the pages of the buffer pool, whatever their size.
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = 0, int internal_max_size = 0);
 
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
@@ -79,7 +92,47 @@ class BPlusTree {
   // expose for test purpose
   Page *FindLeafPage(const KeyType &key, bool leftMost = false);
 
+  /**
+   * Turns on child pointer swizzling: descents then reach a child through the frame hint that the buffer pool keeps
+   * beside its parent (BufferPoolManager::FetchChildPage) and unpin by Page *, so a hot path never hashes page ids.
+   * Set it before the tree is shared between threads.
+   */
+  void SetSwizzling(bool swizzling) { swizzling_ = swizzling; }
+
  private:
+  /**
+   * Descends to the leaf page that contains key, or to the left most leaf page.
+   * For FIND the leaf is returned read latched and no other latch is held. For
+   * INSERT and DELETE the latched pages that may still change are in the page
+   * set of transaction, the leaf last.
+   * @return the pinned and latched leaf page, nullptr if the tree is empty (a
+   * writer then still holds root_latch_)
+   */
+  Page *FindLeafPageByOperation(const KeyType &key, Operation operation, Transaction *transaction,
+                                bool left_most = false);
+
+  /**
+   * Descends to the leaf page for FIND. Internal pages are read optimistically
+   * and the descent starts over from the root if one of them changed meanwhile.
+   * @return the pinned and read latched leaf page, nullptr if the tree is empty
+   */
+  Page *FindLeafPageOptimistically(const KeyType &key, bool left_most);
+
+  /** Fetches the child in the given slot of parent, which must be pinned. */
+  Page *FetchChild(Page *parent, int slot, page_id_t child_id);
+
+  /** Unpins a page that was fetched by this tree. */
+  void Unpin(Page *page, bool is_dirty);
+
+  /** @return true if the operation cannot change the parent of node */
+  bool IsSafe(BPlusTreePage *node, Operation operation);
+
+  /**
+   * Unlatches and unpins every page in the page set of transaction, releasing
+   * root_latch_ for a nullptr entry, then deletes the pages in the deleted page set.
+   */
+  void ReleaseWLatches(Transaction *transaction, bool is_dirty);
+
   void StartNewTree(const KeyType &key, const ValueType &value);
 
   bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
@@ -111,11 +164,15 @@ class BPlusTree {
 
   // member variable
   std::string index_name_;
-  page_id_t root_page_id_;
+  /** Changed only under root_latch_ and the write latch of the old root, but read by readers without a latch. */
+  std::atomic<page_id_t> root_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  bool swizzling_{false};
+  /** Serializes writers that may change root_page_id_. */
+  ReaderWriterLatch root_latch_;
 };
 
 }  // namespace bustub
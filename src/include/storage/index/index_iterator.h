@@ -13,6 +13,7 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include "common/macros.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
@@ -21,23 +22,45 @@ namespace bustub {
 
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using LeafPage = B_PLUS_TREE_LEAF_PAGE_TYPE;
+
  public:
-  // you may define your own constructor based on your member variables
-  IndexIterator();
+  /**
+   * Creates an iterator positioned at index of the given leaf page, or past its last entry if the key range ends
+   * there. The iterator takes over the pin of leaf; a nullptr leaf makes the end iterator.
+   * @param buffer_pool_manager the buffer pool of the tree
+   * @param leaf the pinned leaf page, nullptr for the end iterator
+   * @param index the position inside leaf
+   */
+  IndexIterator(BufferPoolManager *buffer_pool_manager, Page *leaf, int index);
+  IndexIterator(IndexIterator &&other) noexcept;
   ~IndexIterator();
 
+  DISALLOW_COPY(IndexIterator);
+
   bool isEnd();
 
   const MappingType &operator*();
 
   IndexIterator &operator++();
 
-  bool operator==(const IndexIterator &itr) const { throw std::runtime_error("unimplemented"); }
+  bool operator==(const IndexIterator &itr) const { return page_ == itr.page_ && index_ == itr.index_; }
 
-  bool operator!=(const IndexIterator &itr) const { throw std::runtime_error("unimplemented"); }
+  bool operator!=(const IndexIterator &itr) const { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
+  /** Moves on to the next leaf while index_ is past the end of the current one. */
+  void SkipExhaustedLeaves();
+
+  /** Follows the leaf chain of the tree for read-ahead. */
+  static page_id_t NextLeafPageId(Page *page);
+
+  BufferPoolManager *buffer_pool_manager_;
+  /** The pinned current leaf, nullptr at the end. */
+  Page *page_;
+  int index_;
+  /** Number of leaves the iterator moved to since it last asked the buffer pool to read ahead. */
+  int leaves_since_read_ahead_{0};
 };
 
 }  // namespace bustub
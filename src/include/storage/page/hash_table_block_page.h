@@ -13,6 +13,7 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -26,11 +27,12 @@ namespace bustub {
  * non-unique keys.
  *
  * Block page format (keys are stored in order):
- *  ----------------------------------------------------------------
- * | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
- *  ----------------------------------------------------------------
+ *  --------------------------------------------------------------------------------------------------
+ * | NumSlots (4) | OCCUPIED | READABLE | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  --------------------------------------------------------------------------------------------------
  *
- *  Here '+' means concatenation.
+ *  Here '+' means concatenation. The number of slots n follows from the page size, so the occupied and readable
+ *  flags, one bit per slot each, and the pairs are at offsets computed from it.
  *
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
@@ -39,6 +41,22 @@ class HashTableBlockPage {
   // Delete all constructor / destructor to ensure memory safety
   HashTableBlockPage() = delete;
 
+  /**
+   * Initializes a new block page, whose slots fill a page of the given size.
+   *
+   * @param page_size the size of the page, the page size of the buffer pool
+   */
+  void Init(size_t page_size);
+
+  /** @return the number of slots of the block, BLOCK_ARRAY_SIZE(page_size) */
+  slot_offset_t NumSlots() const { return num_slots_; }
+
+  /**
+   * @param page_size the size of a page
+   * @return the number of slots of a block page of that size
+   */
+  static slot_offset_t NumSlotsFor(size_t page_size) { return BLOCK_ARRAY_SIZE(page_size); }
+
   /**
    * Gets the key at an index in the block.
    *
@@ -94,11 +112,28 @@ class HashTableBlockPage {
   bool IsReadable(slot_offset_t bucket_ind) const;
 
  private:
-  std::atomic_char occupied_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
+  /** @return the number of bytes of each of the flag arrays */
+  size_t FlagBytes() const { return (num_slots_ - 1) / 8 + 1; }
+
+  /** @return the occupied flags, one bit per slot */
+  std::atomic_char *Occupied() { return flags_; }
+  const std::atomic_char *Occupied() const { return flags_; }
+
+  /** @return the readable flags, 0 if tombstone/brand new (never occupied), 1 otherwise */
+  std::atomic_char *Readable() { return flags_ + FlagBytes(); }
+  const std::atomic_char *Readable() const { return flags_ + FlagBytes(); }
+
+  /** @return the (key, value) pairs, after the flags */
+  MappingType *Array() { return reinterpret_cast<MappingType *>(const_cast<char *>(ArrayStart())); }
+  const MappingType *Array() const { return reinterpret_cast<const MappingType *>(ArrayStart()); }
+  const char *ArrayStart() const {
+    auto start = reinterpret_cast<uintptr_t>(flags_ + 2 * FlagBytes());
+    return reinterpret_cast<const char *>((start + alignof(MappingType) - 1) / alignof(MappingType) *
+                                          alignof(MappingType));
+  }
 
-  // 0 if tombstone/brand new (never occupied), 1 otherwise.
-  std::atomic_char readable_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
-  MappingType array_[0];
+  uint32_t num_slots_;
+  std::atomic_char flags_[0];
 };
 
 }  // namespace bustub
@@ -14,11 +14,14 @@
 
 #define MappingType std::pair<KeyType, ValueType>
 
-/** BLOCK_ARRAY_SIZE is the number of (key, value) pairs that can be stored in   * a block page. It is an approximate
- * calculation based on the size of MappingType (which is a std::pair of KeyType and ValueType). For each key/value
- * pair, we need two additional bits for occupied_ and readable_. 4 * PAGE_SIZE / (4 * sizeof (MappingType) + 1) =
- * PAGE_SIZE/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required to maintain the occupied
- * and readable flags for a key value pair.*/
-#define BLOCK_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+/** BLOCK_ARRAY_SIZE(page_size) is the number of (key, value) pairs that can be stored in a block page of page_size
+ * bytes. It is an approximate calculation based on the size of MappingType (which is a std::pair of KeyType and
+ * ValueType). For each key/value pair, we need two additional bits for occupied_ and readable_.
+ * 4 * page_size / (4 * sizeof (MappingType) + 1) = page_size/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits
+ * is the space required to maintain the occupied and readable flags for a key value pair. The block page header, the
+ * two bytes by which the flags may round up and the alignment of the pairs are taken off the page first. */
+#define BLOCK_PAGE_HEADER_SIZE 4
+#define BLOCK_ARRAY_SIZE(page_size) \
+  (4 * ((page_size)-BLOCK_PAGE_HEADER_SIZE - 2 - alignof(MappingType)) / (4 * sizeof(MappingType) + 1))
 
 #define HASH_TABLE_BLOCK_TYPE HashTableBlockPage<KeyType, ValueType, KeyComparator>
@@ -12,8 +12,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>  // NOLINT
 #include <cstring>
 #include <iostream>
+#include <thread>  // NOLINT
 
 #include "common/config.h"
 #include "common/rwlatch.h"
@@ -30,15 +33,18 @@ class Page {
   friend class BufferPoolManager;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  /** Constructor. The buffer pool manager hands the page its memory, zeroed. */
+  Page() = default;
 
-  /** Default destructor. */
-  ~Page() = default;
+  /** Destructor. Frees the child frame table, if any. */
+  ~Page() { delete[] child_frames_.load(std::memory_order_relaxed); }
 
   /** @return the actual data contained within this page */
   inline char *GetData() { return data_; }
 
+  /** @return the size of the page data in bytes, the page size of the database file */
+  inline size_t GetPageSize() const { return page_size_; }
+
   /** @return the page id of this page */
   inline page_id_t GetPageId() { return page_id_; }
 
@@ -49,10 +55,18 @@ class Page {
   inline bool IsDirty() { return is_dirty_; }
 
   /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  inline void WLatch() {
+    rwlatch_.WLock();
+    // An odd version tells optimistic readers that the page is being written.
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
 
   /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  inline void WUnlatch() {
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    rwlatch_.WUnlock();
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
@@ -60,6 +74,30 @@ class Page {
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /**
+   * Starts an optimistic read of the page, without taking any latch. Waits while a writer holds the write latch.
+   * The page must be pinned, and what was read may only be used once ValidateVersion confirms it.
+   * @return the version of the page
+   */
+  inline uint64_t ReadVersion() {
+    uint64_t version = version_.load(std::memory_order_acquire);
+    while ((version & 1) != 0) {
+      std::this_thread::yield();
+      version = version_.load(std::memory_order_acquire);
+    }
+    return version;
+  }
+
+  /**
+   * Ends an optimistic read of the page.
+   * @param version the version returned by ReadVersion
+   * @return true if no writer latched the page since, i.e. everything read in between is consistent
+   */
+  inline bool ValidateVersion(uint64_t version) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
+
   /** @return the page LSN. */
   inline lsn_t GetLSN() { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
@@ -76,18 +114,41 @@ class Page {
 
  private:
   /** Zeroes out the data that is held within the page. */
-  inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
+  inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, page_size_); }
+
+  /** Upper bound on the number of child slots of an index page, i.e. on the size of the child frame table. */
+  inline size_t MaxChildSlots() const { return page_size_ / (2 * sizeof(page_id_t)); }
 
-  /** The actual data that is stored within a page. */
-  char data_[PAGE_SIZE]{};
+  /** The actual data that is stored within a page, owned by the buffer pool manager. */
+  char *data_{nullptr};
+  /** The size of data_. */
+  size_t page_size_{0};
   /** The ID of this page. */
   page_id_t page_id_ = INVALID_PAGE_ID;
   /** The pin count of this page. */
   int pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
   bool is_dirty_ = false;
+  /** True while the buffer pool manager is reading this frame in or writing its previous page back. */
+  bool io_in_progress_ = false;
+  /** Signalled, under the buffer pool latch, when io_in_progress_ is cleared. */
+  std::condition_variable io_cv_;
+  /** True if the page is deleted once its last pin is dropped. */
+  bool delete_pending_ = false;
+  /** True if the page was read in by a prefetch request and has not been fetched since. */
+  bool prefetched_ = false;
+  /** The frame of the buffer pool instance that this page object is. */
+  frame_id_t frame_id_ = INVALID_FRAME_ID;
+  /**
+   * Swizzled child pointers: for every child slot of an index page, the frame its child was last found in, or
+   * INVALID_FRAME_ID. Allocated when the page is first used as a parent by BufferPoolManager::FetchChildPage. The
+   * entries are only hints and are checked against the page the frame holds.
+   */
+  std::atomic<std::atomic<frame_id_t> *> child_frames_{nullptr};
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Bumped when the write latch is taken and again when it is released, so it is odd while a writer holds it. */
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
@@ -99,8 +99,12 @@ class TableHeap {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn);
 
-  /** @return the begin iterator of this table */
-  TableIterator Begin(Transaction *txn);
+  /**
+   * @param txn the transaction performing the scan
+   * @param ring the buffer access strategy of a large scan, nullptr to go through the buffer pool as usual
+   * @return the begin iterator of this table
+   */
+  TableIterator Begin(Transaction *txn, BufferRing *ring = nullptr);
 
   /** @return the end iterator of this table */
   TableIterator End();
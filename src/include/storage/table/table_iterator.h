@@ -14,6 +14,7 @@
 
 #include <cassert>
 
+#include "buffer/buffer_ring.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
@@ -29,10 +30,21 @@ class TableIterator {
   friend class Cursor;
 
  public:
-  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
+  /**
+   * Creates a new TableIterator.
+   * @param table_heap the table to iterate over
+   * @param rid the rid of the first tuple
+   * @param txn the transaction performing the scan
+   * @param ring the buffer access strategy of the scan, nullptr to go through the buffer pool as usual
+   */
+  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, BufferRing *ring = nullptr);
 
   TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+      : table_heap_(other.table_heap_),
+        tuple_(new Tuple(*other.tuple_)),
+        txn_(other.txn_),
+        ring_(other.ring_),
+        pages_since_read_ahead_(other.pages_since_read_ahead_) {}
 
   ~TableIterator() { delete tuple_; }
 
@@ -52,6 +64,9 @@ class TableIterator {
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  BufferRing *ring_;
+  /** Number of pages the iterator moved to since it last asked the buffer pool to read ahead. */
+  int pages_since_read_ahead_{0};
 };
 
 }  // namespace bustub
@@ -12,43 +12,165 @@
 
 #include "recovery/log_manager.h"
 
+#include <cstring>
+#include <utility>
+
+#include "common/macros.h"
+
 namespace bustub {
 /*
  * set enable_logging = true
  * Start a separate thread to execute flush to disk operation periodically
  * The flush can be triggered when timeout or the log buffer is full or buffer
  * pool manager wants to force flush (it only happens when the flushed page has
- * a larger LSN than persistent LSN)
+ * a larger LSN than persistent LSN) or a transaction waits for its commit record
  *
  * This thread runs forever until system shutdown/StopFlushThread
  */
-void LogManager::RunFlushThread() {}
+void LogManager::RunFlushThread() {
+  std::scoped_lock lock{latch_};
+  if (flush_thread_ != nullptr) {
+    return;
+  }
+  stop_ = false;
+  flush_thread_ = new std::thread(&LogManager::FlushThread, this);
+  enable_logging = true;
+}
 
 /*
  * Stop and join the flush thread, set enable_logging = false
  */
-void LogManager::StopFlushThread() {}
+void LogManager::StopFlushThread() {
+  {
+    std::scoped_lock lock{latch_};
+    if (flush_thread_ == nullptr) {
+      return;
+    }
+    enable_logging = false;
+    stop_ = true;
+  }
+  cv_.notify_one();
+  flush_thread_->join();
+  delete flush_thread_;
+  flush_thread_ = nullptr;
+}
 
 /*
  * append a log record into log buffer
  * you MUST set the log record's lsn within this method
  * @return: lsn that is assigned to this log record
- *
- *
- * example below
- * // First, serialize the must have fields(20 bytes in total)
- * log_record.lsn_ = next_lsn_++;
- * memcpy(log_buffer_ + offset_, &log_record, 20);
- * int pos = offset_ + 20;
- *
- * if (log_record.log_record_type_ == LogRecordType::INSERT) {
- *    memcpy(log_buffer_ + pos, &log_record.insert_rid_, sizeof(RID));
- *    pos += sizeof(RID);
- *    // we have provided serialize function for tuple class
- *    log_record.insert_tuple_.SerializeTo(log_buffer_ + pos);
- *  }
- *
  */
-lsn_t LogManager::AppendLogRecord(LogRecord *log_record) { return INVALID_LSN; }
+lsn_t LogManager::AppendLogRecord(LogRecord *log_record) {
+  BUSTUB_ASSERT(log_record->size_ <= LOG_BUFFER_SIZE, "log record larger than the log buffer");
+  std::unique_lock lock{latch_};
+  // A full buffer is flushed before the record goes into the emptied one.
+  while (offset_ + log_record->size_ > LOG_BUFFER_SIZE) {
+    RequestFlush(&lock);
+  }
+
+  // First, serialize the must have fields (20 bytes in total)
+  log_record->lsn_ = next_lsn_++;
+  char *pos = log_buffer_ + offset_;
+  memcpy(pos, log_record, LogRecord::HEADER_SIZE);
+  pos += LogRecord::HEADER_SIZE;
+  switch (log_record->log_record_type_) {
+    case LogRecordType::INSERT:
+      memcpy(pos, &log_record->insert_rid_, sizeof(RID));
+      log_record->insert_tuple_.SerializeTo(pos + sizeof(RID));
+      break;
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE:
+      memcpy(pos, &log_record->delete_rid_, sizeof(RID));
+      log_record->delete_tuple_.SerializeTo(pos + sizeof(RID));
+      break;
+    case LogRecordType::UPDATE:
+      memcpy(pos, &log_record->update_rid_, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->old_tuple_.SerializeTo(pos);
+      log_record->new_tuple_.SerializeTo(pos + sizeof(int32_t) + log_record->old_tuple_.GetLength());
+      break;
+    case LogRecordType::NEWPAGE:
+      memcpy(pos, &log_record->prev_page_id_, sizeof(page_id_t));
+      memcpy(pos + sizeof(page_id_t), &log_record->page_id_, sizeof(page_id_t));
+      break;
+    default:
+      break;
+  }
+  offset_ += log_record->size_;
+  return log_record->lsn_;
+}
+
+void LogManager::WaitForFlush(lsn_t lsn) {
+  std::unique_lock lock{latch_};
+  while (persistent_lsn_ < lsn) {
+    bool flush_thread = flush_thread_ != nullptr && !stop_;
+    // A lone commit without a window to wait for others would only pay for waking up the flush thread: it writes the
+    // log itself. Once commits queue up, the flush thread takes over, since it starts each write right after the last.
+    if (!flushing_ && (!flush_thread || (log_group_commit_window.count() == 0 && num_waiters_ == 0))) {
+      FlushBuffer(&lock);
+      continue;
+    }
+    if (flush_thread && lsn > wait_lsn_) {
+      wait_lsn_ = lsn;
+      cv_.notify_one();
+    }
+    num_waiters_++;
+    flushed_cv_.wait(lock);
+    num_waiters_--;
+  }
+}
+
+void LogManager::TruncateLog() {
+  std::unique_lock lock{latch_};
+  // The log written so far ends where the buffered records begin once no flush is in progress.
+  flushed_cv_.wait(lock, [&] { return !flushing_; });
+  disk_manager_->TruncateLog(disk_manager_->GetLogSize());
+}
+
+void LogManager::FlushThread() {
+  std::unique_lock lock{latch_};
+  while (!stop_) {
+    cv_.wait_for(lock, log_timeout, [&] { return stop_ || flush_requested_ || wait_lsn_ > persistent_lsn_; });
+    // Group commit: the first committing transaction waits a little for others to share its flush.
+    if (!stop_ && !flush_requested_ && wait_lsn_ > persistent_lsn_) {
+      cv_.wait_for(lock, log_group_commit_window,
+                   [&] { return stop_ || flush_requested_ || offset_ >= log_group_commit_bytes; });
+    }
+    FlushBuffer(&lock);
+  }
+  FlushBuffer(&lock);
+}
+
+void LogManager::RequestFlush(std::unique_lock<std::mutex> *lock) {
+  if (flush_thread_ != nullptr && !stop_) {
+    flush_requested_ = true;
+    cv_.notify_one();
+    flushed_cv_.wait(*lock);
+  } else {
+    FlushBuffer(lock);
+  }
+}
+
+void LogManager::FlushBuffer(std::unique_lock<std::mutex> *lock) {
+  // Without a flush thread, the threads that flush take turns.
+  flushed_cv_.wait(*lock, [&] { return !flushing_; });
+  flush_requested_ = false;
+  if (offset_ == 0) {
+    return;
+  }
+  // Every record up to the last lsn handed out is in the buffer, since lsns are handed out under the latch.
+  std::swap(log_buffer_, flush_buffer_);
+  size_t size = offset_;
+  lsn_t lsn = next_lsn_ - 1;
+  offset_ = 0;
+  flushing_ = true;
+  lock->unlock();
+  disk_manager_->WriteLog(flush_buffer_, static_cast<int>(size));
+  lock->lock();
+  flushing_ = false;
+  persistent_lsn_ = lsn;
+  flushed_cv_.notify_all();
+}
 
 }  // namespace bustub
@@ -24,8 +24,9 @@ bool LogRecovery::DeserializeLogRecord(const char *data, LogRecord *log_record)
 
 /*
  *redo phase on TABLE PAGE level(table/table_page.h)
- *read log file from the beginning to end (you must prefetch log records into
- *log buffer to reduce unnecessary I/O operations), remember to compare page's
+ *read log from its beginning, the redo point of the last checkpoint, to its end
+ *(you must prefetch log records into log buffer to reduce unnecessary I/O
+ *operations, the segments are read sequentially), remember to compare page's
  *LSN with log_record's sequence number, and also build active_txn_ table &
  *lsn_mapping_ table
  */
@@ -0,0 +1,259 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_disk_io.cpp
+//
+// Identification: src/storage/disk/async_disk_io.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/async_disk_io.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+#include "common/config.h"
+#include "common/exception.h"
+
+namespace bustub {
+
+bool AsyncIORequest::Complete(size_t transferred) {
+  off_t offset = offset_ + static_cast<off_t>(transferred);
+  size_t next = 0;
+  while (true) {
+    // Skip the buffers that were transferred completely and the transferred part of the next one.
+    while (next < iov_.size() && transferred >= iov_[next].iov_len) {
+      transferred -= iov_[next].iov_len;
+      next++;
+    }
+    if (next == iov_.size()) {
+      return true;
+    }
+    iov_[next].iov_base = static_cast<char *>(iov_[next].iov_base) + transferred;
+    iov_[next].iov_len -= transferred;
+
+    int count = static_cast<int>(std::min(iov_.size() - next, static_cast<size_t>(IOV_MAX)));
+    ssize_t n = write_ ? pwritev(fd_, &iov_[next], count, offset) : preadv(fd_, &iov_[next], count, offset);
+    if (n < 0 && errno == EINTR) {
+      transferred = 0;
+      continue;
+    }
+    if (n < 0 || (n == 0 && write_)) {
+      return false;
+    }
+    // The file ends before the read does.
+    if (n == 0) {
+      for (size_t i = next; i < iov_.size(); i++) {
+        memset(iov_[i].iov_base, 0, iov_[i].iov_len);
+      }
+      return true;
+    }
+    transferred = n;
+    offset += n;
+  }
+}
+
+std::unique_ptr<AsyncDiskIO> AsyncDiskIO::Create(size_t queue_depth, bool use_io_uring) {
+  if (use_io_uring) {
+    try {
+      return std::make_unique<IoUringDiskIO>(queue_depth);
+    } catch (const Exception &) {
+      // fall back to the thread pool below
+    }
+  }
+  return std::make_unique<ThreadPoolDiskIO>(std::min(queue_depth, static_cast<size_t>(ASYNC_IO_THREADS)));
+}
+
+IoUringDiskIO::IoUringDiskIO(size_t queue_depth) : queue_depth_(queue_depth) {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned>(queue_depth), &params));
+  if (ring_fd_ < 0) {
+    throw Exception(ExceptionType::NOT_IMPLEMENTED, "io_uring is not available");
+  }
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  // Newer kernels map both rings with a single mmap.
+  if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                  IORING_OFF_SQ_RING);
+  if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+    cq_ring_ = sq_ring_;
+  } else if (sq_ring_ != MAP_FAILED) {
+    cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                    IORING_OFF_CQ_RING);
+  }
+  sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  void *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                    IORING_OFF_SQES);
+  if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes == MAP_FAILED) {
+    if (sqes != MAP_FAILED) {
+      munmap(sqes, sqes_size_);
+    }
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != MAP_FAILED) {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    close(ring_fd_);
+    throw Exception(ExceptionType::NOT_IMPLEMENTED, "io_uring rings cannot be mapped");
+  }
+  sqes_ = static_cast<struct io_uring_sqe *>(sqes);
+
+  auto *sq = static_cast<char *>(sq_ring_);
+  sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  auto *cq = static_cast<char *>(cq_ring_);
+  cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+  // The completion queue holds at least as many entries as the submission queue, so it cannot overflow.
+  queue_depth_ = std::min(queue_depth_, static_cast<size_t>(params.sq_entries));
+
+  completion_thread_ = std::thread(&IoUringDiskIO::RunCompletionThread, this);
+}
+
+IoUringDiskIO::~IoUringDiskIO() {
+  {
+    std::unique_lock lock{latch_};
+    slot_cv_.wait(lock, [this] { return in_flight_ == 0; });
+    Enqueue(IORING_OP_NOP, nullptr);
+  }
+  completion_thread_.join();
+  munmap(sqes_, sqes_size_);
+  if (cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  munmap(sq_ring_, sq_ring_size_);
+  close(ring_fd_);
+}
+
+std::future<bool> IoUringDiskIO::Submit(bool write, int fd, std::vector<struct iovec> iov, off_t offset) {
+  auto *request = new AsyncIORequest{write, fd, std::move(iov), offset, {}};
+  std::future<bool> done = request->done_.get_future();
+  std::unique_lock lock{latch_};
+  slot_cv_.wait(lock, [this] { return in_flight_ < queue_depth_; });
+  in_flight_++;
+  Enqueue(write ? IORING_OP_WRITEV : IORING_OP_READV, request);
+  return done;
+}
+
+void IoUringDiskIO::Enqueue(uint8_t opcode, AsyncIORequest *request) {
+  unsigned tail = *sq_tail_;
+  unsigned index = tail & *sq_mask_;
+  struct io_uring_sqe *sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  if (request != nullptr) {
+    sqe->fd = request->fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(request->iov_.data());
+    sqe->len = static_cast<uint32_t>(request->iov_.size());
+    sqe->off = static_cast<uint64_t>(request->offset_);
+  }
+  sqe->user_data = reinterpret_cast<uint64_t>(request);
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+  // Without SQPOLL the kernel consumes the entry within this call, so the slot is free again once it returns.
+  while (syscall(__NR_io_uring_enter, ring_fd_, 1, 0, 0, nullptr, 0) < 1) {
+    if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+      throw Exception("io_uring submission failed");
+    }
+  }
+}
+
+void IoUringDiskIO::RunCompletionThread() {
+  while (true) {
+    unsigned head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+      syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+      continue;
+    }
+    struct io_uring_cqe *cqe = &cqes_[head & *cq_mask_];
+    auto *request = reinterpret_cast<AsyncIORequest *>(cqe->user_data);
+    int result = cqe->res;
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    if (request == nullptr) {
+      return;
+    }
+
+    size_t size = 0;
+    for (const auto &buffer : request->iov_) {
+      size += buffer.iov_len;
+    }
+    bool success;
+    if (result >= 0 && static_cast<size_t>(result) == size) {
+      success = true;
+    } else if (result == -EINTR || result == -EAGAIN) {
+      success = request->Complete(0);
+    } else {
+      // A short transfer, e.g. a read that reaches the end of the file, is finished right here.
+      success = result >= 0 && request->Complete(result);
+    }
+    request->done_.set_value(success);
+    delete request;
+
+    std::scoped_lock lock{latch_};
+    in_flight_--;
+    slot_cv_.notify_all();
+  }
+}
+
+ThreadPoolDiskIO::ThreadPoolDiskIO(size_t num_threads) {
+  for (size_t i = 0; i < std::max(num_threads, static_cast<size_t>(1)); i++) {
+    workers_.emplace_back(&ThreadPoolDiskIO::RunWorker, this);
+  }
+}
+
+ThreadPoolDiskIO::~ThreadPoolDiskIO() {
+  {
+    std::scoped_lock lock{latch_};
+    stop_ = true;
+    cv_.notify_all();
+  }
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+std::future<bool> ThreadPoolDiskIO::Submit(bool write, int fd, std::vector<struct iovec> iov, off_t offset) {
+  auto request = std::make_unique<AsyncIORequest>(AsyncIORequest{write, fd, std::move(iov), offset, {}});
+  std::future<bool> done = request->done_.get_future();
+  std::scoped_lock lock{latch_};
+  queue_.push_back(std::move(request));
+  cv_.notify_one();
+  return done;
+}
+
+void ThreadPoolDiskIO::RunWorker() {
+  std::unique_lock lock{latch_};
+  while (true) {
+    cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+    // Requests that were submitted before the pool stopped are still served.
+    if (queue_.empty()) {
+      return;
+    }
+    std::unique_ptr<AsyncIORequest> request = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    request->done_.set_value(request->Complete(0));
+    lock.lock();
+  }
+}
+
+}  // namespace bustub
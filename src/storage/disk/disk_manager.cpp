@@ -10,8 +10,15 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <dirent.h>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <climits>
 #include <cstring>
 #include <iostream>
 #include <string>
@@ -19,112 +26,365 @@
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/macros.h"
+#include "common/util/aligned_memory.h"
+#include "common/util/crc32c.h"
+#include "common/util/lz_codec.h"
 #include "storage/disk/disk_manager.h"
 
 namespace bustub {
 
 static char *buffer_used;
 
+/** The first page of the log manifest. */
+struct LogManifest {
+  uint64_t magic_;
+  /** The size of the segments of the log. */
+  uint64_t segment_size_;
+  /** The offset of the first log byte that has not been truncated. */
+  int64_t begin_;
+  /** The end of the log when the manifest was written, which is a record boundary. */
+  int64_t end_;
+  /** The numbers of the first and the last segment of the log. */
+  int64_t first_segment_;
+  int64_t last_segment_;
+};
+
+static constexpr uint64_t LOG_MANIFEST_MAGIC = 0x474f4c5554535542;  // "BUSTULOG" in memory
+
+/**
+ * Reads size bytes at offset, filling the part past the end of the file with zeros
+ * @return false on an I/O error
+ */
+static bool ReadAt(int fd, char *data, size_t size, off_t offset) {
+  size_t read_count = 0;
+  while (read_count < size) {
+    ssize_t n = pread(fd, data + read_count, size - read_count, offset + static_cast<off_t>(read_count));
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    if (n == 0) {
+      break;
+    }
+    read_count += n;
+  }
+  // if file ends before reading everything, e.g. a page that was allocated but never written
+  if (read_count < size) {
+    memset(data + read_count, 0, size - read_count);
+  }
+  return true;
+}
+
+/**
+ * Writes size bytes at offset
+ * @return false on an I/O error
+ */
+static bool WriteAt(int fd, const char *data, size_t size, off_t offset) {
+  size_t written = 0;
+  while (written < size) {
+    ssize_t n = pwrite(fd, data + written, size - written, offset + static_cast<off_t>(written));
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    written += n;
+  }
+  return true;
+}
+
 /**
- * Constructor: open/create a single database file & log file
- * @input db_file: database file name
+ * Constructor: open/create the database files of a tablespace & log file
+ * @input db_files: database file names, the log file is named after the first
  */
-DiskManager::DiskManager(const std::string &db_file)
-    : file_name_(db_file), next_page_id_(0), num_flushes_(0), num_writes_(0), flush_log_(false), flush_log_f_(nullptr) {
+DiskManager::DiskManager(const std::vector<std::string> &db_files, size_t page_size, bool direct_io, bool compress)
+    : DiskManager(page_size) {
+  file_name_ = db_files.empty() ? "" : db_files[0];
+  direct_io_ = direct_io;
+  if (direct_io_ && compress) {
+    throw Exception(ExceptionType::INVALID, "compressed db files cannot be opened with O_DIRECT");
+  }
+  if (db_files.empty() || (compress && db_files.size() > 1)) {
+    throw Exception(ExceptionType::INVALID, "a tablespace needs at least one db file, a compressed one exactly one");
+  }
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
     return;
   }
   log_name_ = file_name_.substr(0, n) + ".log";
+  OpenLog();
 
-  log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
-  // directory or file does not exist
-  if (!log_io_.is_open()) {
-    log_io_.clear();
-    // create a new file
-    log_io_.open(log_name_, std::ios::binary | std::ios::trunc | std::ios::app | std::ios::out);
-    log_io_.close();
-    // reopen with original mode
-    log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
-    if (!log_io_.is_open()) {
-      throw Exception("can't open dblog file");
-    }
-  }
-
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
+  int64_t file_size = 0;
+  int64_t min_file_pages = INT64_MAX;
+  for (const auto &db_file : db_files) {
+    int fd = open(db_file.c_str(), O_RDWR | O_CREAT | (direct_io_ ? O_DIRECT : 0), 0644);
+    if (fd < 0) {
+      throw Exception(direct_io_ ? "can't open db file with O_DIRECT" : "can't open db file");
     }
+    db_fds_.push_back(fd);
+    // A file written with another page size would be read at the wrong offsets.
+    int64_t size = std::max<int64_t>(GetFileSize(db_file), 0);
+    if (!compress && size % page_size_ != 0) {
+      throw Exception(ExceptionType::MISMATCH_TYPE, "db file was created with another page size");
+    }
+    file_size += size;
+    min_file_pages = std::min<int64_t>(min_file_pages, size / page_size_);
+  }
+  // The extent map of a compressed db file is written when the file is created, so it tells the two kinds apart.
+  std::string pmap_name = file_name_.substr(0, n) + ".pmap";
+  bool compressed = file_size > 0 && GetFileSize(pmap_name) > 0;
+  if (file_size > 0 && compressed != compress) {
+    throw Exception(ExceptionType::MISMATCH_TYPE, compress ? "db file is not compressed" : "db file is compressed");
+  }
+  if (compress) {
+    extent_map_ = std::make_unique<PageExtentMap>(pmap_name, page_size_, file_size <= 0);
+  } else if (file_size <= 0) {
+    remove(pmap_name.c_str());
+  }
+  // Only whole stripes in every file count, so that the files grow in step.
+  auto stripes = static_cast<page_id_t>(min_file_pages / TABLESPACE_STRIPE_PAGES);
+  file_pages_ = compress ? 0 : stripes * TABLESPACE_STRIPE_PAGES * static_cast<page_id_t>(db_fds_.size());
+
+  // The map of an empty db file is left over from a removed one.
+  std::string fsm_name = file_name_.substr(0, n) + ".fsm";
+  fsm_fd_ = open(fsm_name.c_str(), O_RDWR | O_CREAT | (file_size <= 0 ? O_TRUNC : 0), 0644);
+  if (fsm_fd_ < 0) {
+    throw Exception("can't open free space map file");
+  }
+  int64_t fsm_size = GetFileSize(fsm_name);
+  size_t map_pages = std::max<int64_t>(fsm_size, 0) / page_size_;
+  allocation_map_.resize(map_pages * page_size_ / sizeof(uint64_t));
+  dirty_map_pages_.resize(map_pages);
+  if (map_pages > 0 && pread(fsm_fd_, allocation_map_.data(), map_pages * page_size_, 0) !=
+                           static_cast<ssize_t>(map_pages * page_size_)) {
+    throw Exception("can't read free space map file");
   }
   buffer_used = nullptr;
 }
 
+/**
+ * Constructor for the backends without files: only check the page size
+ */
+DiskManager::DiskManager(size_t page_size) : page_size_(page_size) {
+  if (page_size_ < MIN_PAGE_SIZE || page_size_ > MAX_PAGE_SIZE || (page_size_ & (page_size_ - 1)) != 0) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "page size must be a power of two in [MIN_PAGE_SIZE, MAX_PAGE_SIZE]");
+  }
+}
+
+DiskManager::~DiskManager() {
+  // The I/Os in flight must finish before the descriptors are closed.
+  async_io_.clear();
+  for (int fd : db_fds_) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+  if (fsm_fd_ >= 0) {
+    WriteAllocationMap();
+    close(fsm_fd_);
+  }
+  CloseLog();
+}
+
 /**
  * Close all file streams
  */
 void DiskManager::ShutDown() {
-  db_io_.close();
-  log_io_.close();
+  CloseLog();
+  for (int &fd : db_fds_) {
+    if (fd >= 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+  if (fsm_fd_ >= 0) {
+    WriteAllocationMap();
+    fdatasync(fsm_fd_);
+    close(fsm_fd_);
+    fsm_fd_ = -1;
+  }
+  if (extent_map_ != nullptr) {
+    extent_map_->Sync();
+  }
 }
 
 /**
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
-  // set write cursor to offset
+  // O_DIRECT needs an aligned buffer; other callers than the buffer pool may not have one.
+  AlignedBuffer bounce;
+  if (direct_io_ && !AlignedMemory::IsAligned(page_data)) {
+    bounce = AlignedMemory::Allocate(page_size_);
+    memcpy(bounce.get(), page_data, page_size_);
+    page_data = bounce.get();
+  }
+  StampChecksum(page_data);
+  if (extent_map_ != nullptr) {
+    WriteCompressedPage(page_id, page_data);
+    return;
+  }
+  off_t offset;
+  size_t file = Locate(page_id, &offset);
   num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
   // check for I/O error
-  if (db_io_.bad()) {
+  if (!WriteAt(db_fds_[file], page_data, page_size_, offset)) {
     LOG_DEBUG("I/O error while writing");
+  }
+}
+
+/**
+ * Write a batch of pages in page id order, one vectored write per run of
+ * pages that are adjacent in the same file. The runs are all submitted before
+ * waiting for any of them, so every device sees them at a queue depth above
+ * one and the files of a tablespace are written in parallel.
+ */
+void DiskManager::WritePages(std::vector<std::pair<page_id_t, const char *>> *pages) {
+  std::sort(pages->begin(), pages->end());
+  if (extent_map_ != nullptr) {
+    for (const auto &[page_id, page_data] : *pages) {
+      WritePage(page_id, page_data);
+    }
     return;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
+  std::vector<std::future<bool>> writes;
+  size_t run_start = 0;
+  while (run_start < pages->size()) {
+    // Extend the run while the pages are adjacent in the file, up to the limit of one pwritev.
+    off_t offset;
+    size_t file = Locate((*pages)[run_start].first, &offset);
+    size_t run_end = run_start + 1;
+    off_t next_offset;
+    while (run_end < pages->size() && run_end - run_start < IOV_MAX &&
+           Locate((*pages)[run_end].first, &next_offset) == file &&
+           next_offset == offset + static_cast<off_t>((run_end - run_start) * page_size_)) {
+      run_end++;
+    }
+    std::vector<struct iovec> iov;
+    iov.reserve(run_end - run_start);
+    for (size_t i = run_start; i < run_end; i++) {
+      BUSTUB_ASSERT(!direct_io_ || AlignedMemory::IsAligned((*pages)[i].second), "unaligned page for O_DIRECT");
+      StampChecksum((*pages)[i].second);
+      iov.push_back({const_cast<char *>((*pages)[i].second), page_size_});
+    }
+    num_writes_ += static_cast<int>(run_end - run_start);
+    writes.push_back(AsyncIO(file)->Write(db_fds_[file], std::move(iov), offset));
+    run_start = run_end;
+  }
+  for (auto &write : writes) {
+    if (!write.get()) {
+      LOG_DEBUG("I/O error while writing");
+    }
+  }
+}
+
+/**
+ * Start writing the specified page, the completion is reported through the future
+ */
+std::future<bool> DiskManager::WritePageAsync(page_id_t page_id, const char *page_data) {
+  BUSTUB_ASSERT(!direct_io_ || AlignedMemory::IsAligned(page_data), "unaligned page for O_DIRECT");
+  if (extent_map_ != nullptr) {
+    WritePage(page_id, page_data);
+    std::promise<bool> done;
+    done.set_value(true);
+    return done.get_future();
+  }
+  StampChecksum(page_data);
+  num_writes_ += 1;
+  off_t offset;
+  size_t file = Locate(page_id, &offset);
+  return AsyncIO(file)->Write(db_fds_[file], {{const_cast<char *>(page_data), page_size_}}, offset);
+}
+
+/**
+ * Sync the db files, a single fdatasync per file for every write before it.
+ * The files of a tablespace are synced in parallel.
+ */
+void DiskManager::SyncPages() {
+  std::vector<std::future<int>> syncs;
+  for (size_t i = 1; i < db_fds_.size(); i++) {
+    syncs.push_back(std::async(std::launch::async, fdatasync, db_fds_[i]));
+  }
+  bool synced = fdatasync(db_fds_[0]) == 0;
+  for (auto &sync : syncs) {
+    synced = sync.get() == 0 && synced;
+  }
+  if (!synced) {
+    LOG_DEBUG("I/O error while syncing");
+  }
+  // After the pages, so that the map never shows a page as free that a synced page refers to.
+  WriteAllocationMap();
+  if (fsm_fd_ >= 0 && fdatasync(fsm_fd_) != 0) {
+    LOG_DEBUG("I/O error while syncing the free space map");
+  }
+  // Likewise, the extent map may only point to the new slots of pages once these are durable.
+  if (extent_map_ != nullptr) {
+    extent_map_->Sync();
+  }
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  int offset = page_id * PAGE_SIZE;
-  // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
-    LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
+  if (direct_io_ && !AlignedMemory::IsAligned(page_data)) {
+    AlignedBuffer bounce = AlignedMemory::Allocate(page_size_);
+    ReadPage(page_id, bounce.get());
+    memcpy(page_data, bounce.get(), page_size_);
+    return;
+  }
+  bool read;
+  if (extent_map_ != nullptr) {
+    read = ReadCompressedPage(page_id, page_data);
   } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    if (db_io_.bad()) {
-      LOG_DEBUG("I/O error while reading");
-      return;
-    }
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
-      LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+    off_t offset;
+    size_t file = Locate(page_id, &offset);
+    read = ReadAt(db_fds_[file], page_data, page_size_, offset);
+  }
+  if (!read) {
+    LOG_DEBUG("I/O error while reading");
+    return;
+  }
+  if (!VerifyChecksum(page_id, page_data)) {
+    throw Exception(ExceptionType::CORRUPTION, "page " + std::to_string(page_id) + " does not match its checksum");
+  }
+}
+
+/**
+ * Start reading the specified page, the completion is reported through the future
+ */
+std::future<bool> DiskManager::ReadPageAsync(page_id_t page_id, char *page_data) {
+  BUSTUB_ASSERT(!direct_io_ || AlignedMemory::IsAligned(page_data), "unaligned page for O_DIRECT");
+  if (extent_map_ != nullptr) {
+    std::promise<bool> done;
+    try {
+      ReadPage(page_id, page_data);
+      done.set_value(true);
+    } catch (const Exception &) {
+      done.set_value(false);
     }
+    return done.get_future();
+  }
+  off_t offset;
+  size_t file = Locate(page_id, &offset);
+  std::future<bool> read = AsyncIO(file)->Read(db_fds_[file], {{page_data, page_size_}}, offset);
+  if (!enable_page_checksums) {
+    return read;
   }
+  // The page is verified by the thread that waits for it, so that the completion thread only reaps completions.
+  return std::async(std::launch::deferred, [this, page_id, page_data, read = std::move(read)]() mutable {
+    return read.get() && VerifyChecksum(page_id, page_data);
+  });
 }
 
 /**
  * Write the contents of the log into disk file
- * Only return when sync is done, and only perform sequence write
+ * Only return when the log is durable, and only perform sequence write
  */
 void DiskManager::WriteLog(char *log_data, int size) {
   // enforce swap log buffer
@@ -142,17 +402,28 @@ void DiskManager::WriteLog(char *log_data, int size) {
     assert(flush_log_f_->wait_for(std::chrono::seconds(10)) == std::future_status::ready);
   }
 
+  std::scoped_lock lock{log_latch_};
+  if (log_segments_.empty()) {
+    LOG_DEBUG("log is not open");
+    return;
+  }
   num_flushes_ += 1;
-  // sequence write
-  log_io_.write(log_data, size);
-
-  // check for I/O error
-  if (log_io_.bad()) {
+  int64_t end = log_size_ + size;
+  while ((log_first_segment_ + static_cast<int64_t>(log_segments_.size())) * log_segment_size_ < end) {
+    AddLogSegment();
+  }
+  // sequence write, then a single fdatasync per segment that makes every record in the buffer durable
+  if (!AccessLog(log_data, size, log_size_, true)) {
     LOG_DEBUG("I/O error while writing log");
     return;
   }
-  // needs to flush to keep disk file in sync
-  log_io_.flush();
+  for (int64_t segment = log_size_ / log_segment_size_; segment <= (end - 1) / log_segment_size_; segment++) {
+    if (fdatasync(log_segments_[segment - log_first_segment_]) != 0) {
+      LOG_DEBUG("I/O error while syncing log");
+      return;
+    }
+  }
+  log_size_ = end;
   flush_log_ = false;
 }
 
@@ -161,41 +432,142 @@ void DiskManager::WriteLog(char *log_data, int size) {
  * Always read from the beginning and perform sequence read
  * @return: false means already reach the end
  */
-bool DiskManager::ReadLog(char *log_data, int size, int offset) {
-  if (offset >= GetFileSize(log_name_)) {
-    // LOG_DEBUG("end of log file");
-    // LOG_DEBUG("file size is %d", GetFileSize(log_name_));
+bool DiskManager::ReadLog(char *log_data, int size, int64_t offset) {
+  std::scoped_lock lock{log_latch_};
+  if (offset < log_begin_ || offset >= log_size_) {
     return false;
   }
-  log_io_.seekp(offset);
-  log_io_.read(log_data, size);
-
-  if (log_io_.bad()) {
+  // if log ends before reading "size", the rest is zeroed
+  size_t read_count = std::min<int64_t>(size, log_size_ - offset);
+  if (!AccessLog(log_data, read_count, offset, false)) {
     LOG_DEBUG("I/O error while reading log");
     return false;
   }
-  // if log file ends before reading "size"
-  int read_count = log_io_.gcount();
-  if (read_count < size) {
-    log_io_.clear();
-    memset(log_data + read_count, 0, size - read_count);
-  }
-
+  memset(log_data + read_count, 0, size - read_count);
   return true;
 }
 
+/**
+ * Release the segments before the one that holds offset: zero and rename them
+ * for reuse while there are few recycled ones, remove the others
+ */
+void DiskManager::TruncateLog(int64_t offset) {
+  std::scoped_lock lock{log_latch_};
+  if (log_segments_.empty() || offset <= log_begin_) {
+    return;
+  }
+  log_begin_ = std::min<int64_t>(offset, log_size_);
+  int64_t last_segment = log_first_segment_ + static_cast<int64_t>(log_segments_.size()) - 1;
+  int64_t first_segment = std::min(log_begin_ / log_segment_size_, last_segment);
+  // The manifest moves past the segments before they are released, so a crash leaves none that the log needs.
+  WriteLogManifest(first_segment);
+  while (log_first_segment_ < first_segment) {
+    int fd = log_segments_.front();
+    std::string name = LogSegmentName(log_first_segment_);
+    log_segments_.pop_front();
+    log_first_segment_++;
+    if (recycled_segments_.size() < LOG_RECYCLED_SEGMENTS &&
+        (fallocate(fd, FALLOC_FL_ZERO_RANGE, 0, log_segment_size_) == 0 ||
+         (ftruncate(fd, 0) == 0 && ftruncate(fd, log_segment_size_) == 0))) {
+      int64_t segment = recycled_segments_.empty() ? last_segment + 1 : recycled_segments_.back() + 1;
+      if (rename(name.c_str(), LogSegmentName(segment).c_str()) == 0) {
+        recycled_segments_.push_back(segment);
+        close(fd);
+        continue;
+      }
+    }
+    close(fd);
+    unlink(name.c_str());
+  }
+}
+
 /**
  * Allocate new page (operations like create index/table)
- * For now just keep an increasing counter
+ * Take the lowest free page id of the allocation bitmap, growing the bitmap
+ * and the db file as needed
  */
-page_id_t DiskManager::AllocatePage() { return next_page_id_++; }
+page_id_t DiskManager::AllocatePage() { return AllocatePage(1, 0); }
+
+/**
+ * Allocate new page with an id of the given remainder: skip whole words of
+ * the bitmap while any id will do, step through the ids of the remainder
+ * otherwise
+ */
+page_id_t DiskManager::AllocatePage(size_t modulus, size_t remainder) {
+  std::scoped_lock lock{allocation_latch_};
+  size_t page = first_free_hint_;
+  if (modulus == 1) {
+    size_t word = page / 64;
+    while (word < allocation_map_.size() && allocation_map_[word] == ~static_cast<uint64_t>(0)) {
+      word++;
+    }
+    page = word < allocation_map_.size() ? word * 64 + __builtin_ctzll(~allocation_map_[word]) : word * 64;
+  } else {
+    page += (remainder + modulus - page % modulus) % modulus;
+    while (page / 64 < allocation_map_.size() && (allocation_map_[page / 64] >> (page % 64) & 1) != 0) {
+      page += modulus;
+    }
+  }
+  size_t words_per_map_page = page_size_ / sizeof(uint64_t);
+  while (page / 64 >= allocation_map_.size()) {
+    allocation_map_.resize(allocation_map_.size() + words_per_map_page);
+    dirty_map_pages_.push_back(true);
+  }
+  auto page_id = static_cast<page_id_t>(page);
+  allocation_map_[page / 64] |= static_cast<uint64_t>(1) << (page % 64);
+  dirty_map_pages_[page / 64 / words_per_map_page] = true;
+  // Every id below the hint is taken; ids of other remainders below this one may still be free.
+  if (modulus == 1 || page_id == first_free_hint_) {
+    first_free_hint_ = page_id + 1;
+  }
+
+  if (extent_map_ == nullptr && !db_fds_.empty() && page_id >= file_pages_) {
+    // Whole extents keep the files contiguous on disk; file systems without fallocate grow the files on write instead.
+    // Every file of a tablespace grows by one extent, which is a whole number of stripes.
+    auto files = static_cast<page_id_t>(db_fds_.size());
+    page_id_t new_file_pages = (page_id / (FILE_EXTENT_PAGES * files) + 1) * FILE_EXTENT_PAGES * files;
+    auto offset = static_cast<off_t>(file_pages_ / files) * static_cast<off_t>(page_size_);
+    auto length = static_cast<off_t>((new_file_pages - file_pages_) / files) * static_cast<off_t>(page_size_);
+    bool grown = true;
+    for (int fd : db_fds_) {
+      grown = (fallocate(fd, 0, offset, length) == 0 || errno == EOPNOTSUPP) && grown;
+    }
+    if (grown) {
+      file_pages_ = new_file_pages;
+    } else {
+      LOG_DEBUG("I/O error while growing the db file");
+    }
+  }
+  return page_id;
+}
 
 /**
  * Deallocate page (operations like drop index/table)
- * Need bitmap in header page for tracking pages
- * This does not actually need to do anything for now.
+ * Clear its bit, so that the next allocation reuses it
+ */
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  if (extent_map_ != nullptr) {
+    extent_map_->Remove(page_id);
+  }
+  std::scoped_lock lock{allocation_latch_};
+  if (page_id < 0 || static_cast<size_t>(page_id) / 64 >= allocation_map_.size()) {
+    return;
+  }
+  allocation_map_[page_id / 64] &= ~(static_cast<uint64_t>(1) << (page_id % 64));
+  dirty_map_pages_[page_id / 64 / (page_size_ / sizeof(uint64_t))] = true;
+  first_free_hint_ = std::min(first_free_hint_, page_id);
+}
+
+/**
+ * Returns whether the page is allocated according to the bitmap
  */
-void DiskManager::DeallocatePage(__attribute__((unused)) page_id_t page_id) {}
+bool DiskManager::IsPageAllocated(page_id_t page_id) {
+  std::scoped_lock lock{allocation_latch_};
+  if (page_id < 0 || static_cast<size_t>(page_id) / 64 >= allocation_map_.size()) {
+    return false;
+  }
+  return (allocation_map_[page_id / 64] >> (page_id % 64) & 1) != 0;
+}
 
 /**
  * Returns number of flushes made so far
@@ -212,13 +584,305 @@ int DiskManager::GetNumWrites() const { return num_writes_; }
  */
 bool DiskManager::GetFlushState() const { return flush_log_; }
 
+/**
+ * Private helper function to write the changed pages of the allocation map
+ */
+void DiskManager::WriteAllocationMap() {
+  std::scoped_lock lock{allocation_latch_};
+  if (fsm_fd_ < 0) {
+    return;
+  }
+  size_t words_per_map_page = page_size_ / sizeof(uint64_t);
+  for (size_t i = 0; i < dirty_map_pages_.size(); i++) {
+    if (!dirty_map_pages_[i]) {
+      continue;
+    }
+    auto offset = static_cast<off_t>(i * page_size_);
+    if (pwrite(fsm_fd_, &allocation_map_[i * words_per_map_page], page_size_, offset) !=
+        static_cast<ssize_t>(page_size_)) {
+      LOG_DEBUG("I/O error while writing the free space map");
+      return;
+    }
+    dirty_map_pages_[i] = false;
+  }
+}
+
+/**
+ * Private helper function to stamp the checksum of a page into its trailer.
+ * The trailer is reserved for the checksum, so the page may be changed in place.
+ * A checksum of zero is stored as ~0, since zero marks a page without one.
+ */
+void DiskManager::StampChecksum(const char *page_data) {
+  if (!enable_page_checksums) {
+    return;
+  }
+  size_t size = page_size_ - PAGE_CHECKSUM_SIZE;
+  uint32_t checksum = Crc32c::Compute(page_data, size);
+  checksum = checksum == 0 ? ~checksum : checksum;
+  memcpy(const_cast<char *>(page_data) + size, &checksum, sizeof(checksum));
+}
+
+/**
+ * Private helper function to verify the checksum of a page, if it has one
+ */
+bool DiskManager::VerifyChecksum(page_id_t page_id, const char *page_data) {
+  if (!enable_page_checksums) {
+    return true;
+  }
+  size_t size = page_size_ - PAGE_CHECKSUM_SIZE;
+  uint32_t stored;
+  memcpy(&stored, page_data + size, sizeof(stored));
+  if (stored == 0) {
+    return true;
+  }
+  uint32_t checksum = Crc32c::Compute(page_data, size);
+  if ((checksum == 0 ? ~checksum : checksum) == stored) {
+    return true;
+  }
+  num_checksum_failures_ += 1;
+  LOG_DEBUG("page %d does not match its checksum", page_id);
+  return false;
+}
+
+/**
+ * Private helper function to write a page of a compressed db file.
+ * A compressed page is stored with its length in front. A page that would not
+ * take up fewer slot units compressed than raw is stored raw.
+ */
+void DiskManager::WriteCompressedPage(page_id_t page_id, const char *page_data) {
+  std::vector<char> slot(page_size_);
+  auto length = static_cast<uint32_t>(LZCodec::Compress(page_data, page_size_, slot.data() + sizeof(uint32_t),
+                                                        page_size_ - COMPRESSION_SLOT_SIZE - sizeof(uint32_t)));
+  bool raw = length == 0;
+  size_t size = raw ? page_size_ : sizeof(length) + length;
+  memcpy(slot.data(), &length, sizeof(length));
+  PageExtent extent = extent_map_->Place(page_id, size, raw);
+  num_writes_ += 1;
+  if (!WriteAt(db_fds_[0], raw ? page_data : slot.data(), size, static_cast<off_t>(extent.offset_))) {
+    LOG_DEBUG("I/O error while writing");
+  }
+}
+
+/**
+ * Private helper function to read a page of a compressed db file
+ * @return false on an I/O error
+ */
+bool DiskManager::ReadCompressedPage(page_id_t page_id, char *page_data) {
+  PageExtent extent;
+  if (!extent_map_->Find(page_id, &extent)) {
+    memset(page_data, 0, page_size_);
+    return true;
+  }
+  if (extent.raw_ != 0) {
+    return ReadAt(db_fds_[0], page_data, page_size_, static_cast<off_t>(extent.offset_));
+  }
+  std::vector<char> slot(extent.capacity_);
+  if (!ReadAt(db_fds_[0], slot.data(), slot.size(), static_cast<off_t>(extent.offset_))) {
+    return false;
+  }
+  uint32_t length;
+  memcpy(&length, slot.data(), sizeof(length));
+  if (length > slot.size() - sizeof(length) ||
+      !LZCodec::Decompress(slot.data() + sizeof(length), length, page_data, page_size_)) {
+    throw Exception(ExceptionType::CORRUPTION, "page " + std::to_string(page_id) + " cannot be decompressed");
+  }
+  return true;
+}
+
+/**
+ * Private helper function to set up the asynchronous I/O on first use, so that
+ * disk managers that never use it start no threads. Every file gets its own
+ * queue, so that a busy volume does not hold up the others.
+ */
+AsyncDiskIO *DiskManager::AsyncIO(size_t file) {
+  std::call_once(async_io_once_, [this] {
+    for (size_t i = 0; i < db_fds_.size(); i++) {
+      async_io_.push_back(AsyncDiskIO::Create(ASYNC_IO_QUEUE_DEPTH));
+    }
+  });
+  return async_io_[file].get();
+}
+
+/**
+ * Private helper function to find a page in the tablespace: runs of
+ * TABLESPACE_STRIPE_PAGES pages go to the files in turn
+ */
+size_t DiskManager::Locate(page_id_t page_id, off_t *offset) const {
+  size_t stripe = static_cast<size_t>(page_id) / TABLESPACE_STRIPE_PAGES;
+  size_t file_page = stripe / db_fds_.size() * TABLESPACE_STRIPE_PAGES + page_id % TABLESPACE_STRIPE_PAGES;
+  *offset = static_cast<off_t>(file_page) * static_cast<off_t>(page_size_);
+  return stripe % db_fds_.size();
+}
+
+/**
+ * Private helper function to open the log: read the manifest, remove the
+ * segments it no longer lists, and find the end of the log from the last end
+ * it recorded
+ */
+void DiskManager::OpenLog() {
+  log_fd_ = open(log_name_.c_str(), O_RDWR | O_CREAT, 0644);
+  if (log_fd_ < 0) {
+    throw Exception("can't open dblog file");
+  }
+  LogManifest manifest{LOG_MANIFEST_MAGIC, log_segment_size, 0, 0, 0, -1};
+  int64_t manifest_size = GetFileSize(log_name_);
+  if (manifest_size > 0 && (pread(log_fd_, &manifest, sizeof(manifest), 0) != sizeof(manifest) ||
+                            manifest.magic_ != LOG_MANIFEST_MAGIC || manifest.segment_size_ == 0)) {
+    close(log_fd_);
+    log_fd_ = -1;
+    throw Exception(ExceptionType::MISMATCH_TYPE, "dblog file is not a log manifest");
+  }
+  log_segment_size_ = manifest.segment_size_;
+  log_first_segment_ = manifest.first_segment_;
+
+  // The segment files are named after the manifest: test.log has test.log.0, test.log.1, ...
+  std::string::size_type slash = log_name_.rfind('/');
+  std::string dir_name = slash == std::string::npos ? "." : log_name_.substr(0, slash + 1);
+  std::string prefix = log_name_.substr(slash == std::string::npos ? 0 : slash + 1) + ".";
+  DIR *dir = opendir(dir_name.c_str());
+  if (dir != nullptr) {
+    for (dirent *entry = readdir(dir); entry != nullptr; entry = readdir(dir)) {
+      std::string name = entry->d_name;
+      if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+          name.find_first_not_of("0123456789", prefix.size()) != std::string::npos) {
+        continue;
+      }
+      int64_t segment = std::stoll(name.substr(prefix.size()));
+      if (manifest.last_segment_ < log_first_segment_ || segment < log_first_segment_) {
+        // left over from a removed log, or released before a crash
+        unlink(LogSegmentName(segment).c_str());
+      } else if (segment > manifest.last_segment_) {
+        recycled_segments_.push_back(segment);
+      }
+    }
+    closedir(dir);
+  }
+  std::sort(recycled_segments_.begin(), recycled_segments_.end());
+
+  for (int64_t segment = log_first_segment_; segment <= manifest.last_segment_; segment++) {
+    int fd = open(LogSegmentName(segment).c_str(), O_RDWR);
+    if (fd < 0) {
+      CloseLog();
+      throw Exception("can't open log segment file");
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    log_segments_.push_back(fd);
+  }
+  std::scoped_lock lock{log_latch_};
+  log_begin_ = manifest.begin_;
+  if (log_segments_.empty()) {
+    AddLogSegment();
+    return;
+  }
+  // Every record starts with its size, and the log past the end reads as zeros.
+  int64_t end = manifest.end_;
+  int64_t segments_end = (manifest.last_segment_ + 1) * log_segment_size_;
+  int32_t record_size = 0;
+  while (end + static_cast<int64_t>(sizeof(record_size)) <= segments_end &&
+         AccessLog(reinterpret_cast<char *>(&record_size), sizeof(record_size), end, false) && record_size > 0 &&
+         end + record_size <= segments_end) {
+    end += record_size;
+  }
+  log_size_ = end;
+}
+
+/**
+ * Private helper function to write the manifest with the end of the log and
+ * close the segments
+ */
+void DiskManager::CloseLog() {
+  std::scoped_lock lock{log_latch_};
+  if (log_fd_ < 0) {
+    return;
+  }
+  if (!log_segments_.empty()) {
+    WriteLogManifest(log_first_segment_);
+  }
+  for (int fd : log_segments_) {
+    close(fd);
+  }
+  log_segments_.clear();
+  close(log_fd_);
+  log_fd_ = -1;
+}
+
+/**
+ * Private helper function to write the manifest over the first page of the
+ * manifest file and sync it. The log starts at first_segment, which is past
+ * log_first_segment_ while the segments before it are being released.
+ */
+void DiskManager::WriteLogManifest(int64_t first_segment) {
+  LogManifest manifest{LOG_MANIFEST_MAGIC, static_cast<uint64_t>(log_segment_size_), log_begin_, log_size_,
+                       first_segment, log_first_segment_ + static_cast<int64_t>(log_segments_.size()) - 1};
+  if (!WriteAt(log_fd_, reinterpret_cast<const char *>(&manifest), sizeof(manifest), 0) || fdatasync(log_fd_) != 0) {
+    LOG_DEBUG("I/O error while writing log manifest");
+  }
+}
+
+/**
+ * Private helper function to add a segment to the log: rename the lowest
+ * recycled file to it, or create a file of the segment size, and only then
+ * list it in the manifest
+ */
+void DiskManager::AddLogSegment() {
+  std::string name = LogSegmentName(log_first_segment_ + static_cast<int64_t>(log_segments_.size()));
+  bool recycled = false;
+  // The recycled files are numbered beyond the last segment, so the lowest one is renamed over no other file.
+  while (!recycled && !recycled_segments_.empty()) {
+    recycled = rename(LogSegmentName(recycled_segments_.front()).c_str(), name.c_str()) == 0;
+    recycled_segments_.erase(recycled_segments_.begin());
+  }
+  int fd = open(name.c_str(), O_RDWR | O_CREAT | (recycled ? 0 : O_TRUNC), 0644);
+  if (fd < 0) {
+    throw Exception("can't open log segment file");
+  }
+  // File systems without fallocate read the holes of a sparse segment as zeros just as well.
+  if (!recycled && fallocate(fd, 0, 0, log_segment_size_) != 0) {
+    ftruncate(fd, log_segment_size_);
+  }
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  log_segments_.push_back(fd);
+  // The segment must survive a crash before the manifest lists it.
+  std::string::size_type slash = name.rfind('/');
+  int dir_fd = open(slash == std::string::npos ? "." : name.substr(0, slash + 1).c_str(), O_RDONLY | O_DIRECTORY);
+  if (dir_fd >= 0) {
+    fsync(dir_fd);
+    close(dir_fd);
+  }
+  WriteLogManifest(log_first_segment_);
+}
+
+/**
+ * Private helper function to name the file of a log segment after the manifest
+ */
+std::string DiskManager::LogSegmentName(int64_t segment) const { return log_name_ + "." + std::to_string(segment); }
+
+/**
+ * Private helper function to read or write a range of the log, one piece per
+ * segment it spans
+ */
+bool DiskManager::AccessLog(char *log_data, size_t size, int64_t offset, bool write) {
+  while (size > 0) {
+    int fd = log_segments_[offset / log_segment_size_ - log_first_segment_];
+    auto segment_offset = static_cast<off_t>(offset % log_segment_size_);
+    size_t count = std::min<size_t>(size, log_segment_size_ - segment_offset);
+    if (!(write ? WriteAt(fd, log_data, count, segment_offset) : ReadAt(fd, log_data, count, segment_offset))) {
+      return false;
+    }
+    log_data += count;
+    offset += count;
+    size -= count;
+  }
+  return true;
+}
+
 /**
  * Private helper function to get disk file size
  */
-int DiskManager::GetFileSize(const std::string &file_name) {
+int64_t DiskManager::GetFileSize(const std::string &file_name) {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
-  return rc == 0 ? static_cast<int>(stat_buf.st_size) : -1;
+  return rc == 0 ? static_cast<int64_t>(stat_buf.st_size) : -1;
 }
 
 }  // namespace bustub
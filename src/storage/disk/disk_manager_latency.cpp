@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_latency.cpp
+//
+// Identification: src/storage/disk/disk_manager_latency.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_latency.h"
+
+#include <algorithm>
+#include <thread>  // NOLINT
+
+namespace bustub {
+
+DiskLatencyModel DiskLatencyModel::Ssd() {
+  DiskLatencyModel model;
+  model.read_latency_ = std::chrono::microseconds(100);
+  model.write_latency_ = std::chrono::microseconds(30);
+  model.sync_latency_ = std::chrono::microseconds(200);
+  model.bandwidth_ = 2000000000;
+  model.queue_depth_ = 32;
+  return model;
+}
+
+DiskLatencyModel DiskLatencyModel::Hdd() {
+  DiskLatencyModel model;
+  model.read_latency_ = std::chrono::microseconds(8000);
+  model.write_latency_ = std::chrono::microseconds(8000);
+  model.sync_latency_ = std::chrono::microseconds(8000);
+  model.bandwidth_ = 150000000;
+  model.queue_depth_ = 1;
+  return model;
+}
+
+DiskManagerLatency::DiskManagerLatency(DiskManager *backend, const DiskLatencyModel &model)
+    : DiskManager(backend->GetPageSize()),
+      backend_(backend),
+      model_(model),
+      busy_until_(std::max<size_t>(model.queue_depth_, 1)) {}
+
+void DiskManagerLatency::WritePage(page_id_t page_id, const char *page_data) {
+  Clock::time_point done = Schedule(model_.write_latency_, page_size_);
+  backend_->WritePage(page_id, page_data);
+  std::this_thread::sleep_until(done);
+}
+
+/**
+ * Books one request per run of adjacent pages, all at once, and waits for the last to complete
+ */
+void DiskManagerLatency::WritePages(std::vector<std::pair<page_id_t, const char *>> *pages) {
+  backend_->WritePages(pages);
+  Clock::time_point done = Clock::now();
+  size_t run_start = 0;
+  while (run_start < pages->size()) {
+    size_t run_end = run_start + 1;
+    while (run_end < pages->size() && (*pages)[run_end].first == (*pages)[run_end - 1].first + 1) {
+      run_end++;
+    }
+    done = std::max(done, Schedule(model_.write_latency_, (run_end - run_start) * page_size_));
+    run_start = run_end;
+  }
+  std::this_thread::sleep_until(done);
+}
+
+std::future<bool> DiskManagerLatency::WritePageAsync(page_id_t page_id, const char *page_data) {
+  Clock::time_point done = Schedule(model_.write_latency_, page_size_);
+  return std::async(std::launch::deferred, [done, write = backend_->WritePageAsync(page_id, page_data)]() mutable {
+    std::this_thread::sleep_until(done);
+    return write.get();
+  });
+}
+
+void DiskManagerLatency::SyncPages() {
+  Clock::time_point done = Schedule(model_.sync_latency_, 0, true);
+  backend_->SyncPages();
+  std::this_thread::sleep_until(done);
+}
+
+void DiskManagerLatency::ReadPage(page_id_t page_id, char *page_data) {
+  std::this_thread::sleep_until(Schedule(model_.read_latency_, page_size_));
+  backend_->ReadPage(page_id, page_data);
+}
+
+std::future<bool> DiskManagerLatency::ReadPageAsync(page_id_t page_id, char *page_data) {
+  Clock::time_point done = Schedule(model_.read_latency_, page_size_);
+  return std::async(std::launch::deferred, [done, read = backend_->ReadPageAsync(page_id, page_data)]() mutable {
+    std::this_thread::sleep_until(done);
+    return read.get();
+  });
+}
+
+/**
+ * The log is written and synced as one request
+ */
+void DiskManagerLatency::WriteLog(char *log_data, int size) {
+  if (size == 0) {
+    backend_->WriteLog(log_data, size);
+    return;
+  }
+  Clock::time_point done = Schedule(model_.write_latency_ + model_.sync_latency_, size);
+  backend_->WriteLog(log_data, size);
+  std::this_thread::sleep_until(done);
+}
+
+bool DiskManagerLatency::ReadLog(char *log_data, int size, int64_t offset) {
+  std::this_thread::sleep_until(Schedule(model_.read_latency_, size));
+  return backend_->ReadLog(log_data, size, offset);
+}
+
+DiskManagerLatency::Clock::time_point DiskManagerLatency::Schedule(std::chrono::microseconds latency, size_t bytes,
+                                                                   bool barrier) {
+  std::scoped_lock lock{latch_};
+  auto slot = std::min_element(busy_until_.begin(), busy_until_.end());
+  Clock::time_point start = std::max(Clock::now(), *slot);
+  if (barrier) {
+    start = std::max({start, *std::max_element(busy_until_.begin(), busy_until_.end()), transfer_until_});
+  }
+  Clock::time_point done = start + latency;
+  if (model_.bandwidth_ != 0) {
+    auto transfer = std::chrono::nanoseconds(bytes * 1000000000 / model_.bandwidth_);
+    transfer_until_ = std::max(done, transfer_until_) + transfer;
+    done = transfer_until_;
+  }
+  *slot = done;
+  return done;
+}
+
+}  // namespace bustub
@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_memory.cpp
+//
+// Identification: src/storage/disk/disk_manager_memory.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_memory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "common/exception.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+DiskManagerMemory::DiskManagerMemory(size_t page_size) : DiskManager(page_size) {}
+
+void DiskManagerMemory::WritePage(page_id_t page_id, const char *page_data) {
+  StampChecksum(page_data);
+  char *page = GetPage(page_id, true);
+  num_writes_ += 1;
+  std::scoped_lock lock{page_latches_[page_id % NUM_PAGE_LATCHES]};
+  memcpy(page, page_data, page_size_);
+}
+
+void DiskManagerMemory::WritePages(std::vector<std::pair<page_id_t, const char *>> *pages) {
+  std::sort(pages->begin(), pages->end());
+  for (const auto &[page_id, page_data] : *pages) {
+    WritePage(page_id, page_data);
+  }
+}
+
+std::future<bool> DiskManagerMemory::WritePageAsync(page_id_t page_id, const char *page_data) {
+  WritePage(page_id, page_data);
+  std::promise<bool> done;
+  done.set_value(true);
+  return done.get_future();
+}
+
+void DiskManagerMemory::ReadPage(page_id_t page_id, char *page_data) {
+  char *page = GetPage(page_id, false);
+  {
+    std::scoped_lock lock{page_latches_[page_id % NUM_PAGE_LATCHES]};
+    if (page == nullptr) {
+      memset(page_data, 0, page_size_);
+    } else {
+      memcpy(page_data, page, page_size_);
+    }
+  }
+  if (!VerifyChecksum(page_id, page_data)) {
+    throw Exception(ExceptionType::CORRUPTION, "page " + std::to_string(page_id) + " does not match its checksum");
+  }
+}
+
+std::future<bool> DiskManagerMemory::ReadPageAsync(page_id_t page_id, char *page_data) {
+  std::promise<bool> done;
+  try {
+    ReadPage(page_id, page_data);
+    done.set_value(true);
+  } catch (const Exception &) {
+    done.set_value(false);
+  }
+  return done.get_future();
+}
+
+void DiskManagerMemory::WriteLog(char *log_data, int size) {
+  if (size == 0) {
+    return;
+  }
+  std::scoped_lock lock{log_latch_};
+  num_flushes_ += 1;
+  log_.insert(log_.end(), log_data, log_data + size);
+  log_size_ += size;
+}
+
+bool DiskManagerMemory::ReadLog(char *log_data, int size, int64_t offset) {
+  std::scoped_lock lock{log_latch_};
+  if (offset < log_begin_ || offset >= log_size_) {
+    return false;
+  }
+  // if the log ends before reading "size", the rest is zeroed
+  size_t read_count = std::min<int64_t>(size, log_size_ - offset);
+  memcpy(log_data, log_.data() + (offset - log_begin_), read_count);
+  memset(log_data + read_count, 0, size - read_count);
+  return true;
+}
+
+void DiskManagerMemory::TruncateLog(int64_t offset) {
+  std::scoped_lock lock{log_latch_};
+  if (offset <= log_begin_) {
+    return;
+  }
+  offset = std::min<int64_t>(offset, log_size_);
+  log_.erase(log_.begin(), log_.begin() + (offset - log_begin_));
+  log_.shrink_to_fit();
+  log_begin_ = offset;
+}
+
+char *DiskManagerMemory::GetPage(page_id_t page_id, bool create) {
+  BUSTUB_ASSERT(page_id >= 0, "invalid page id");
+  size_t chunk = page_id / MEMORY_CHUNK_PAGES;
+  size_t offset = page_id % MEMORY_CHUNK_PAGES * page_size_;
+  {
+    std::shared_lock lock{chunks_latch_};
+    if (chunk < chunks_.size() && chunks_[chunk] != nullptr) {
+      return chunks_[chunk].get() + offset;
+    }
+    if (!create) {
+      return nullptr;
+    }
+  }
+  std::unique_lock lock{chunks_latch_};
+  if (chunk >= chunks_.size()) {
+    chunks_.resize(chunk + 1);
+  }
+  if (chunks_[chunk] == nullptr) {
+    chunks_[chunk] = std::make_unique<char[]>(MEMORY_CHUNK_PAGES * page_size_);
+  }
+  return chunks_[chunk].get() + offset;
+}
+
+}  // namespace bustub
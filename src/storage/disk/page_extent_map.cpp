@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_extent_map.cpp
+//
+// Identification: src/storage/disk/page_extent_map.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/page_extent_map.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+PageExtentMap::PageExtentMap(const std::string &file_name, size_t page_size, bool truncate)
+    : page_size_(page_size), free_slots_(page_size / COMPRESSION_SLOT_SIZE + 1) {
+  fd_ = open(file_name.c_str(), O_RDWR | O_CREAT | (truncate ? O_TRUNC : 0), 0644);
+  if (fd_ < 0) {
+    throw Exception("can't open page extent map file");
+  }
+  struct stat stat_buf;
+  size_t map_pages = fstat(fd_, &stat_buf) == 0 ? stat_buf.st_size / page_size_ : 0;
+  extents_.resize(map_pages * page_size_ / sizeof(PageExtent));
+  dirty_map_pages_.resize(map_pages);
+  if (map_pages > 0 && pread(fd_, extents_.data(), map_pages * page_size_, 0) !=
+                           static_cast<ssize_t>(map_pages * page_size_)) {
+    close(fd_);
+    throw Exception("can't read page extent map file");
+  }
+  // A new map is written right away, so that the map file tells compressed database files apart from the others.
+  if (map_pages == 0) {
+    extents_.resize(page_size_ / sizeof(PageExtent));
+    dirty_map_pages_.push_back(true);
+    WriteMap();
+  }
+
+  // The gaps between the slots in use are free, in pieces of at most a page.
+  std::vector<std::pair<uint64_t, uint32_t>> slots;
+  for (const auto &extent : extents_) {
+    if (extent.capacity_ != 0) {
+      slots.emplace_back(extent.offset_, extent.capacity_);
+    }
+  }
+  std::sort(slots.begin(), slots.end());
+  for (const auto &[offset, capacity] : slots) {
+    for (uint64_t gap = file_end_; gap < offset;) {
+      uint64_t size = std::min<uint64_t>(offset - gap, page_size_);
+      free_slots_[size / COMPRESSION_SLOT_SIZE].push_back(gap);
+      gap += size;
+    }
+    file_end_ = std::max(file_end_, offset + capacity);
+  }
+}
+
+PageExtentMap::~PageExtentMap() {
+  std::scoped_lock lock{latch_};
+  WriteMap();
+  close(fd_);
+}
+
+bool PageExtentMap::Find(page_id_t page_id, PageExtent *extent) {
+  std::scoped_lock lock{latch_};
+  if (page_id < 0 || static_cast<size_t>(page_id) >= extents_.size() || extents_[page_id].capacity_ == 0) {
+    return false;
+  }
+  *extent = extents_[page_id];
+  return true;
+}
+
+PageExtent PageExtentMap::Place(page_id_t page_id, size_t size, bool raw) {
+  std::scoped_lock lock{latch_};
+  size_t entries_per_map_page = page_size_ / sizeof(PageExtent);
+  if (static_cast<size_t>(page_id) >= extents_.size()) {
+    size_t map_pages = page_id / entries_per_map_page + 1;
+    extents_.resize(map_pages * entries_per_map_page);
+    dirty_map_pages_.resize(map_pages, true);
+  }
+  PageExtent &extent = extents_[page_id];
+  if (extent.capacity_ != 0 && (extent.raw_ != 0) == raw && size <= extent.capacity_) {
+    return extent;
+  }
+
+  if (extent.capacity_ != 0) {
+    left_slots_.emplace_back(extent.offset_, extent.capacity_);
+  }
+  size_t units = raw ? page_size_ / COMPRESSION_SLOT_SIZE : (size + COMPRESSION_SLOT_SIZE - 1) / COMPRESSION_SLOT_SIZE;
+  auto &free = free_slots_[units];
+  if (free.empty()) {
+    extent.offset_ = file_end_;
+    file_end_ += units * COMPRESSION_SLOT_SIZE;
+  } else {
+    extent.offset_ = free.back();
+    free.pop_back();
+  }
+  extent.capacity_ = static_cast<uint32_t>(units * COMPRESSION_SLOT_SIZE);
+  extent.raw_ = raw ? 1 : 0;
+  dirty_map_pages_[page_id / entries_per_map_page] = true;
+  return extent;
+}
+
+void PageExtentMap::Remove(page_id_t page_id) {
+  std::scoped_lock lock{latch_};
+  if (page_id < 0 || static_cast<size_t>(page_id) >= extents_.size() || extents_[page_id].capacity_ == 0) {
+    return;
+  }
+  left_slots_.emplace_back(extents_[page_id].offset_, extents_[page_id].capacity_);
+  extents_[page_id] = {0, 0, 0};
+  dirty_map_pages_[page_id / (page_size_ / sizeof(PageExtent))] = true;
+}
+
+void PageExtentMap::Sync() {
+  std::scoped_lock lock{latch_};
+  WriteMap();
+  if (fdatasync(fd_) != 0) {
+    LOG_DEBUG("I/O error while syncing the page extent map");
+    return;
+  }
+  for (const auto &[offset, capacity] : left_slots_) {
+    free_slots_[capacity / COMPRESSION_SLOT_SIZE].push_back(offset);
+  }
+  left_slots_.clear();
+}
+
+uint64_t PageExtentMap::GetFileSize() {
+  std::scoped_lock lock{latch_};
+  return file_end_;
+}
+
+void PageExtentMap::WriteMap() {
+  size_t entries_per_map_page = page_size_ / sizeof(PageExtent);
+  for (size_t i = 0; i < dirty_map_pages_.size(); i++) {
+    if (!dirty_map_pages_[i]) {
+      continue;
+    }
+    auto offset = static_cast<off_t>(i * page_size_);
+    if (pwrite(fd_, &extents_[i * entries_per_map_page], page_size_, offset) != static_cast<ssize_t>(page_size_)) {
+      LOG_DEBUG("I/O error while writing the page extent map");
+      return;
+    }
+    dirty_map_pages_[i] = false;
+  }
+}
+
+}  // namespace bustub
@@ -25,14 +25,16 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manag
       root_page_id_(INVALID_PAGE_ID),
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
-      leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {}
+      leaf_max_size_(leaf_max_size != 0 ? leaf_max_size
+                                        : LeafPage::MaxSizeFor(buffer_pool_manager->GetUsablePageSize())),
+      internal_max_size_(internal_max_size != 0 ? internal_max_size
+                                                : InternalPage::MaxSizeFor(buffer_pool_manager->GetUsablePageSize())) {}
 
 /*
  * Helper function to decide whether current b+tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::IsEmpty() const { return true; }
+bool BPLUSTREE_TYPE::IsEmpty() const { return root_page_id_ == INVALID_PAGE_ID; }
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
@@ -43,7 +45,19 @@ bool BPLUSTREE_TYPE::IsEmpty() const { return true; }
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
-  return false;
+  Page *page = FindLeafPageByOperation(key, Operation::FIND, transaction);
+  if (page == nullptr) {
+    return false;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  ValueType value;
+  bool found = leaf->Lookup(key, &value, comparator_);
+  page->RUnlatch();
+  Unpin(page, false);
+  if (found) {
+    result->push_back(value);
+  }
+  return found;
 }
 
 /*****************************************************************************
@@ -57,7 +71,14 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * keys return false, otherwise return true.
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) { return false; }
+bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  if (transaction == nullptr) {
+    // The latches held during the operation are tracked in a transaction.
+    Transaction local_transaction(INVALID_TXN_ID);
+    return InsertIntoLeaf(key, value, &local_transaction);
+  }
+  return InsertIntoLeaf(key, value, transaction);
+}
 /*
  * Insert constant key & value pair into an empty tree
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
@@ -65,7 +86,19 @@ bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  * tree's root page id and insert entry directly into leaf page.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {}
+void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all pages are pinned while starting a new tree");
+  }
+  auto *root = reinterpret_cast<LeafPage *>(page->GetData());
+  root->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+  root->Insert(key, value, comparator_);
+  root_page_id_ = page_id;
+  UpdateRootPageId(1);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
 
 /*
  * Insert constant key & value pair into leaf page
@@ -77,7 +110,25 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {}
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction) {
-  return false;
+  Page *page = FindLeafPageByOperation(key, Operation::INSERT, transaction);
+  if (page == nullptr) {
+    StartNewTree(key, value);
+    ReleaseWLatches(transaction, true);
+    return true;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  ValueType existing;
+  if (leaf->Lookup(key, &existing, comparator_)) {
+    ReleaseWLatches(transaction, false);
+    return false;
+  }
+  if (leaf->Insert(key, value, comparator_) >= leaf->GetMaxSize()) {
+    LeafPage *new_leaf = Split(leaf);
+    InsertIntoParent(leaf, new_leaf->KeyAt(0), new_leaf, transaction);
+    buffer_pool_manager_->UnpinPage(new_leaf->GetPageId(), true);
+  }
+  ReleaseWLatches(transaction, true);
+  return true;
 }
 
 /*
@@ -90,7 +141,16 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
 N *BPLUSTREE_TYPE::Split(N *node) {
-  return nullptr;
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all pages are pinned while splitting a page");
+  }
+  // The new page is reachable only through node and its parent, which are both write latched.
+  auto *new_node = reinterpret_cast<N *>(page->GetData());
+  new_node->Init(page_id, node->GetParentPageId(), node->GetMaxSize());
+  node->MoveHalfTo(new_node, buffer_pool_manager_);
+  return new_node;
 }
 
 /*
@@ -104,7 +164,36 @@ N *BPLUSTREE_TYPE::Split(N *node) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
-                                      Transaction *transaction) {}
+                                      Transaction *transaction) {
+  if (old_node->IsRootPage()) {
+    page_id_t page_id;
+    Page *page = buffer_pool_manager_->NewPage(&page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "all pages are pinned while growing the tree");
+    }
+    auto *root = reinterpret_cast<InternalPage *>(page->GetData());
+    root->Init(page_id, INVALID_PAGE_ID, internal_max_size_);
+    root->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
+    old_node->SetParentPageId(page_id);
+    new_node->SetParentPageId(page_id);
+    root_page_id_ = page_id;
+    UpdateRootPageId(0);
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    return;
+  }
+
+  // The parent is not safe for the insertion, so it is still write latched by this thread.
+  page_id_t parent_id = old_node->GetParentPageId();
+  auto *parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(parent_id)->GetData());
+  parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
+  new_node->SetParentPageId(parent_id);
+  if (parent->GetSize() > parent->GetMaxSize()) {
+    InternalPage *new_internal = Split(parent);
+    InsertIntoParent(parent, new_internal->KeyAt(0), new_internal, transaction);
+    buffer_pool_manager_->UnpinPage(new_internal->GetPageId(), true);
+  }
+  buffer_pool_manager_->UnpinPage(parent_id, true);
+}
 
 /*****************************************************************************
  * REMOVE
@@ -117,19 +206,79 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
  * necessary.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {}
+void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  if (transaction == nullptr) {
+    Transaction local_transaction(INVALID_TXN_ID);
+    Remove(key, &local_transaction);
+    return;
+  }
+  Page *page = FindLeafPageByOperation(key, Operation::DELETE, transaction);
+  if (page == nullptr) {
+    ReleaseWLatches(transaction, false);
+    return;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int size = leaf->GetSize();
+  if (leaf->RemoveAndDeleteRecord(key, comparator_) == size) {
+    ReleaseWLatches(transaction, false);
+    return;
+  }
+  CoalesceOrRedistribute(leaf, transaction);
+  ReleaseWLatches(transaction, true);
+}
 
 /*
  * User needs to first find the sibling of input page. If sibling's size + input
  * page's size > page's max size, then redistribute. Otherwise, merge.
  * Using template N to represent either internal page or leaf page.
+ * Pages that become empty are added to the deleted page set of transaction.
  * @return: true means target leaf page should be deleted, false means no
  * deletion happens
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
 bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
-  return false;
+  if (node->IsRootPage()) {
+    if (AdjustRoot(node)) {
+      transaction->AddIntoDeletedPageSet(node->GetPageId());
+      return true;
+    }
+    return false;
+  }
+  if (node->GetSize() >= node->GetMinSize()) {
+    return false;
+  }
+
+  // The parent is not safe for the deletion, so it is still write latched by this thread. The sibling is not.
+  page_id_t parent_id = node->GetParentPageId();
+  auto *parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(parent_id)->GetData());
+  int index = parent->ValueIndex(node->GetPageId());
+  page_id_t sibling_id = parent->ValueAt(index == 0 ? 1 : index - 1);
+  Page *sibling_page = buffer_pool_manager_->FetchPage(sibling_id);
+  if (sibling_page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all pages are pinned while rebalancing the tree");
+  }
+  sibling_page->WLatch();
+  auto *sibling = reinterpret_cast<N *>(sibling_page->GetData());
+
+  // A leaf splits once it reaches max size, an internal page once it exceeds it.
+  int merged_size = node->GetSize() + sibling->GetSize();
+  bool fits = node->IsLeafPage() ? merged_size < node->GetMaxSize() : merged_size <= node->GetMaxSize();
+  bool node_deleted = false;
+  if (!fits) {
+    Redistribute(sibling, node, index);
+  } else if (index == 0) {
+    // Always merge the right page into the left one.
+    N *left = node;
+    Coalesce(&left, &sibling, &parent, 1, transaction);
+  } else {
+    Coalesce(&sibling, &node, &parent, index, transaction);
+    node_deleted = true;
+  }
+  sibling_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(sibling_id, true);
+  buffer_pool_manager_->UnpinPage(parent_id, true);
+  return node_deleted;
 }
 
 /*
@@ -149,7 +298,18 @@ template <typename N>
 bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
                               BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> **parent, int index,
                               Transaction *transaction) {
-  return false;
+  // neighbor_node is the left page, node the right one at position index of parent.
+  if ((*node)->IsLeafPage()) {
+    auto *leaf = reinterpret_cast<LeafPage *>(*node);
+    leaf->MoveAllTo(reinterpret_cast<LeafPage *>(*neighbor_node), index, buffer_pool_manager_);
+  } else {
+    auto *internal = reinterpret_cast<InternalPage *>(*node);
+    internal->MoveAllTo(reinterpret_cast<InternalPage *>(*neighbor_node), (*parent)->KeyAt(index),
+                        buffer_pool_manager_);
+  }
+  (*parent)->Remove(index);
+  transaction->AddIntoDeletedPageSet((*node)->GetPageId());
+  return CoalesceOrRedistribute(*parent, transaction);
 }
 
 /*
@@ -163,7 +323,34 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
-void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {}
+void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
+  page_id_t parent_id = node->GetParentPageId();
+  auto *parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(parent_id)->GetData());
+  // The separator in the parent is the one of the right page of the pair.
+  int separator = index == 0 ? 1 : index;
+  if (node->IsLeafPage()) {
+    auto *leaf = reinterpret_cast<LeafPage *>(node);
+    auto *neighbor = reinterpret_cast<LeafPage *>(neighbor_node);
+    if (index == 0) {
+      neighbor->MoveFirstToEndOf(leaf, buffer_pool_manager_);
+      parent->SetKeyAt(separator, neighbor->KeyAt(0));
+    } else {
+      neighbor->MoveLastToFrontOf(leaf, index, buffer_pool_manager_);
+      parent->SetKeyAt(separator, leaf->KeyAt(0));
+    }
+  } else {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    auto *neighbor = reinterpret_cast<InternalPage *>(neighbor_node);
+    if (index == 0) {
+      neighbor->MoveFirstToEndOf(internal, parent->KeyAt(separator), buffer_pool_manager_);
+      parent->SetKeyAt(separator, neighbor->KeyAt(0));
+    } else {
+      neighbor->MoveLastToFrontOf(internal, parent->KeyAt(separator), buffer_pool_manager_);
+      parent->SetKeyAt(separator, internal->KeyAt(0));
+    }
+  }
+  buffer_pool_manager_->UnpinPage(parent_id, true);
+}
 /*
  * Update root page if necessary
  * NOTE: size of root page can be less than min size and this method is only
@@ -175,7 +362,26 @@ void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {}
  * happend
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) { return false; }
+bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
+  if (!old_root_node->IsLeafPage() && old_root_node->GetSize() == 1) {
+    auto *old_root = reinterpret_cast<InternalPage *>(old_root_node);
+    root_page_id_ = old_root->RemoveAndReturnOnlyChild();
+    Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "all pages are pinned while shrinking the tree");
+    }
+    reinterpret_cast<BPlusTreePage *>(page->GetData())->SetParentPageId(INVALID_PAGE_ID);
+    buffer_pool_manager_->UnpinPage(root_page_id_, true);
+    UpdateRootPageId(0);
+    return true;
+  }
+  if (old_root_node->IsLeafPage() && old_root_node->GetSize() == 0) {
+    root_page_id_ = INVALID_PAGE_ID;
+    UpdateRootPageId(0);
+    return true;
+  }
+  return false;
+}
 
 /*****************************************************************************
  * INDEX ITERATOR
@@ -186,7 +392,13 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) { return false; }
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() { return INDEXITERATOR_TYPE(); }
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() {
+  Page *page = FindLeafPageByOperation(KeyType{}, Operation::FIND, nullptr, true);
+  if (page != nullptr) {
+    page->RUnlatch();
+  }
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, page, 0);
+}
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
@@ -194,7 +406,15 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() { return INDEXITERATOR_TYPE(); }
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) { return INDEXITERATOR_TYPE(); }
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
+  Page *page = FindLeafPageByOperation(key, Operation::FIND, nullptr);
+  if (page == nullptr) {
+    return INDEXITERATOR_TYPE(buffer_pool_manager_, nullptr, 0);
+  }
+  int index = reinterpret_cast<LeafPage *>(page->GetData())->KeyIndex(key, comparator_);
+  page->RUnlatch();
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, page, index);
+}
 
 /*
  * Input parameter is void, construct an index iterator representing the end
@@ -202,7 +422,7 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) { return INDEXITERA
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE BPLUSTREE_TYPE::end() { return INDEXITERATOR_TYPE(); }
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::end() { return INDEXITERATOR_TYPE(buffer_pool_manager_, nullptr, 0); }
 
 /*****************************************************************************
  * UTILITIES AND DEBUG
@@ -210,10 +430,145 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::end() { return INDEXITERATOR_TYPE(); }
 /*
  * Find leaf page containing particular key, if leftMost flag == true, find
  * the left most leaf page
+ * The leaf is returned pinned but not latched.
  */
 INDEX_TEMPLATE_ARGUMENTS
 Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
-  throw Exception(ExceptionType::NOT_IMPLEMENTED, "Implement this for test");
+  Page *page = FindLeafPageByOperation(key, Operation::FIND, nullptr, leftMost);
+  if (page != nullptr) {
+    page->RUnlatch();
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindLeafPageByOperation(const KeyType &key, Operation operation, Transaction *transaction,
+                                              bool left_most) {
+  if (operation == Operation::FIND) {
+    return FindLeafPageOptimistically(key, left_most);
+  }
+
+  root_latch_.WLock();
+  transaction->AddIntoPageSet(nullptr);
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  while (true) {
+    if (page == nullptr) {
+      ReleaseWLatches(transaction, false);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "all pages are pinned while searching the tree");
+    }
+    page->WLatch();
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (IsSafe(node, operation)) {
+      ReleaseWLatches(transaction, false);
+    }
+    transaction->AddIntoPageSet(page);
+    if (node->IsLeafPage()) {
+      return page;
+    }
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    int slot = left_most ? 0 : internal->ChildIndex(key, comparator_);
+    page = FetchChild(page, slot, internal->ValueAt(slot));
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindLeafPageOptimistically(const KeyType &key, bool left_most) {
+  while (true) {
+    page_id_t page_id = root_page_id_;
+    if (page_id == INVALID_PAGE_ID) {
+      return nullptr;
+    }
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "all pages are pinned while searching the tree");
+    }
+    uint64_t version = page->ReadVersion();
+    // The root only changes while its write latch is held, so it is still the root as of this version.
+    bool restart = root_page_id_ != page_id;
+    while (!restart) {
+      auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+      if (node->IsLeafPage()) {
+        page->RLatch();
+        if (page->ValidateVersion(version)) {
+          return page;
+        }
+        page->RUnlatch();
+        break;
+      }
+      auto *internal = reinterpret_cast<InternalPage *>(node);
+      int slot = left_most ? 0 : internal->ChildIndex(key, comparator_);
+      page_id_t child_id = internal->ValueAt(slot);
+      if (!page->ValidateVersion(version)) {
+        break;
+      }
+      Page *child = FetchChild(page, slot, child_id);
+      if (child == nullptr) {
+        Unpin(page, false);
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "all pages are pinned while searching the tree");
+      }
+      uint64_t child_version = child->ReadVersion();
+      // Unless the parent is unchanged, the child may have been split or merged before its version was read.
+      restart = !page->ValidateVersion(version);
+      Unpin(page, false);
+      page = child;
+      version = child_version;
+    }
+    Unpin(page, false);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FetchChild(Page *parent, int slot, page_id_t child_id) {
+  if (swizzling_) {
+    return buffer_pool_manager_->FetchChildPage(parent, slot, child_id);
+  }
+  return buffer_pool_manager_->FetchPage(child_id);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Unpin(Page *page, bool is_dirty) {
+  if (swizzling_) {
+    buffer_pool_manager_->UnpinPage(page, is_dirty);
+  } else {
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::IsSafe(BPlusTreePage *node, Operation operation) {
+  if (operation == Operation::INSERT) {
+    // A leaf splits once it reaches max size, an internal page once it exceeds it.
+    return node->IsLeafPage() ? node->GetSize() + 1 < node->GetMaxSize() : node->GetSize() < node->GetMaxSize();
+  }
+  if (node->IsRootPage()) {
+    // The root changes when its last key goes (leaf) or when it is left with a single child (internal).
+    return node->IsLeafPage() ? node->GetSize() > 1 : node->GetSize() > 2;
+  }
+  return node->GetSize() > node->GetMinSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseWLatches(Transaction *transaction, bool is_dirty) {
+  auto page_set = transaction->GetPageSet();
+  while (!page_set->empty()) {
+    Page *page = page_set->front();
+    page_set->pop_front();
+    if (page == nullptr) {
+      root_latch_.WUnlock();
+      continue;
+    }
+    page->WUnlatch();
+    Unpin(page, is_dirty);
+  }
+  auto deleted_page_set = transaction->GetDeletedPageSet();
+  // An optimistic reader may still hold a pin on a deleted page, taken before it found out that the parent changed.
+  for (page_id_t page_id : *deleted_page_set) {
+    buffer_pool_manager_->DeletePageWhenUnpinned(page_id);
+  }
+  deleted_page_set->clear();
 }
 
 /*
@@ -227,13 +582,14 @@ Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
   HeaderPage *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
-  if (insert_record != 0) {
-    // create a new record<index_name + root_page_id> in header_page
-    header_page->InsertRecord(index_name_, root_page_id_);
-  } else {
+  // The header page is shared by every index.
+  header_page->WLatch();
+  // A tree that became empty and starts over already has its record.
+  if (insert_record == 0 || !header_page->InsertRecord(index_name_, root_page_id_)) {
     // update root_page_id in header_page
     header_page->UpdateRecord(index_name_, root_page_id_);
   }
+  header_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
 }
 
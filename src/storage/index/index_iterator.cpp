@@ -3,28 +3,100 @@
  */
 #include <cassert>
 
+#include "common/exception.h"
 #include "storage/index/index_iterator.h"
 
 namespace bustub {
 
 /*
- * NOTE: you can change the destructor/constructor method here
- * set your own input parameters
+ * The iterator only keeps its leaf pinned; the leaf is read latched while the
+ * iterator looks at it, so that it never waits for a latch while holding one.
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator() = default;
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *buffer_pool_manager, Page *leaf, int index)
+    : buffer_pool_manager_(buffer_pool_manager), page_(leaf), index_(index) {
+  if (page_ != nullptr) {
+    page_->RLatch();
+    page_id_t next_page_id = reinterpret_cast<LeafPage *>(page_->GetData())->GetNextPageId();
+    page_->RUnlatch();
+    buffer_pool_manager_->PrefetchPageChain(next_page_id, READ_AHEAD_PAGES, NextLeafPageId);
+    SkipExhaustedLeaves();
+  }
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator() = default;
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+    : buffer_pool_manager_(other.buffer_pool_manager_),
+      page_(other.page_),
+      index_(other.index_),
+      leaves_since_read_ahead_(other.leaves_since_read_ahead_) {
+  other.page_ = nullptr;
+  other.index_ = 0;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-bool INDEXITERATOR_TYPE::isEnd() { throw std::runtime_error("unimplemented"); }
+INDEXITERATOR_TYPE::~IndexIterator() {
+  if (page_ != nullptr) {
+    buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+  }
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-const MappingType &INDEXITERATOR_TYPE::operator*() { throw std::runtime_error("unimplemented"); }
+bool INDEXITERATOR_TYPE::isEnd() { return page_ == nullptr; }
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() { throw std::runtime_error("unimplemented"); }
+const MappingType &INDEXITERATOR_TYPE::operator*() {
+  assert(page_ != nullptr);
+  return reinterpret_cast<LeafPage *>(page_->GetData())->GetItem(index_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
+  assert(page_ != nullptr);
+  index_++;
+  SkipExhaustedLeaves();
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipExhaustedLeaves() {
+  while (page_ != nullptr) {
+    page_->RLatch();
+    auto *leaf = reinterpret_cast<LeafPage *>(page_->GetData());
+    if (index_ < leaf->GetSize()) {
+      page_->RUnlatch();
+      return;
+    }
+    page_id_t next_page_id = leaf->GetNextPageId();
+    page_->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+    page_ = nullptr;
+    index_ = 0;
+    if (next_page_id == INVALID_PAGE_ID) {
+      return;
+    }
+    page_ = buffer_pool_manager_->FetchPage(next_page_id);
+    if (page_ == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "all pages are pinned while moving to the next leaf");
+    }
+    // Keep the next READ_AHEAD_PAGES leaves on their way in; asking every half window overlaps the reads with the
+    // scan.
+    if (++leaves_since_read_ahead_ >= READ_AHEAD_PAGES / 2) {
+      leaves_since_read_ahead_ = 0;
+      page_->RLatch();
+      page_id_t read_ahead_page_id = reinterpret_cast<LeafPage *>(page_->GetData())->GetNextPageId();
+      page_->RUnlatch();
+      buffer_pool_manager_->PrefetchPageChain(read_ahead_page_id, READ_AHEAD_PAGES, NextLeafPageId);
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t INDEXITERATOR_TYPE::NextLeafPageId(Page *page) {
+  // The link was read without the latch of the previous leaf, so the page may have been reused by now.
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  return leaf->IsLeafPage() ? leaf->GetNextPageId() : INVALID_PAGE_ID;
+}
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
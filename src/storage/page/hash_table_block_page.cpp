@@ -15,6 +15,11 @@
 
 namespace bustub {
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::Init(size_t page_size) {
+  num_slots_ = NumSlotsFor(page_size);
+}
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 KeyType HASH_TABLE_BLOCK_TYPE::KeyAt(slot_offset_t bucket_ind) const {
   return {};
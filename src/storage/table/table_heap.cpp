@@ -31,13 +31,13 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
   auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(&first_page_id_));
   BUSTUB_ASSERT(first_page != nullptr, "Couldn't create a page for the table heap.");
   first_page->WLatch();
-  first_page->Init(first_page_id_, PAGE_SIZE, INVALID_LSN, log_manager_, txn);
+  first_page->Init(first_page_id_, buffer_pool_manager_->GetUsablePageSize(), INVALID_LSN, log_manager_, txn);
   first_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
 }
 
 bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
-  if (tuple.size_ + 32 > PAGE_SIZE) {  // larger than one page size
+  if (tuple.size_ + 32 > buffer_pool_manager_->GetUsablePageSize()) {  // larger than one page size
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
@@ -75,7 +75,8 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
       // Otherwise we were able to create a new page. We initialize it now.
       new_page->WLatch();
       cur_page->SetNextPageId(next_page_id);
-      new_page->Init(next_page_id, PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
+      new_page->Init(next_page_id, buffer_pool_manager_->GetUsablePageSize(), cur_page->GetTablePageId(), log_manager_,
+                     txn);
       cur_page->WUnlatch();
       buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
       cur_page = new_page;
@@ -169,16 +170,16 @@ bool TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn) {
   return res;
 }
 
-TableIterator TableHeap::Begin(Transaction *txn) {
+TableIterator TableHeap::Begin(Transaction *txn, BufferRing *ring) {
   // Start an iterator from the first page.
-  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_, ring));
   page->RLatch();
   RID rid;
   // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
   page->GetFirstTupleRid(&rid);
   page->RUnlatch();
   buffer_pool_manager_->UnpinPage(first_page_id_, false);
-  return TableIterator(this, rid, txn);
+  return TableIterator(this, rid, txn, ring);
 }
 
 TableIterator TableHeap::End() { return TableIterator(this, RID(INVALID_PAGE_ID, 0), nullptr); }
@@ -16,10 +16,24 @@
 
 namespace bustub {
 
-TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn)
-    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn) {
+/** Follows the page list of the table heap for read-ahead. */
+static page_id_t NextTablePageId(Page *page) { return static_cast<TablePage *>(page)->GetNextPageId(); }
+
+TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, BufferRing *ring)
+    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn), ring_(ring) {
   if (rid.GetPageId() != INVALID_PAGE_ID) {
-    table_heap_->GetTuple(tuple_->rid_, tuple_, txn_);
+    BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+    buffer_pool_manager->PrefetchPageChain(rid.GetPageId(), READ_AHEAD_PAGES + 1, NextTablePageId);
+    // TableHeap::Begin has just fetched the first page to find the rid.
+    auto page = static_cast<TablePage *>(buffer_pool_manager->FetchPageAgain(rid.GetPageId(), ring_));
+    if (page == nullptr) {
+      txn_->SetState(TransactionState::ABORTED);
+      return;
+    }
+    page->RLatch();
+    page->GetTuple(tuple_->rid_, tuple_, txn_, table_heap_->lock_manager_);
+    page->RUnlatch();
+    buffer_pool_manager->UnpinPage(rid.GetPageId(), false);
   }
 }
 
@@ -35,7 +49,8 @@ Tuple *TableIterator::operator->() {
 
 TableIterator &TableIterator::operator++() {
   BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId()));
+  // The page of the current tuple was fetched for that tuple already; only the pages moved to are new references.
+  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPageAgain(tuple_->rid_.GetPageId(), ring_));
   cur_page->RLatch();
   assert(cur_page != nullptr);  // all pages are pinned
 
@@ -43,11 +58,16 @@ TableIterator &TableIterator::operator++() {
   if (!cur_page->GetNextTupleRid(tuple_->rid_,
                                  &next_tuple_rid)) {  // end of this page
     while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
+      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId(), ring_));
       cur_page->RUnlatch();
       buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
       cur_page = next_page;
       cur_page->RLatch();
+      // Keep the next READ_AHEAD_PAGES pages on their way in; asking every half window overlaps the reads with the scan.
+      if (++pages_since_read_ahead_ >= READ_AHEAD_PAGES / 2) {
+        pages_since_read_ahead_ = 0;
+        buffer_pool_manager->PrefetchPageChain(cur_page->GetNextPageId(), READ_AHEAD_PAGES, NextTablePageId);
+      }
       if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
         break;
       }
@@ -56,7 +76,7 @@ TableIterator &TableIterator::operator++() {
   tuple_->rid_ = next_tuple_rid;
 
   if (*this != table_heap_->End()) {
-    table_heap_->GetTuple(tuple_->rid_, tuple_, txn_);
+    cur_page->GetTuple(tuple_->rid_, tuple_, txn_, table_heap_->lock_manager_);
   }
   // release until copy the tuple
   cur_page->RUnlatch();
@@ -0,0 +1,200 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer_test.cpp
+//
+// Identification: test/buffer/arc_replacer_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/arc_replacer.h"
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+namespace {
+
+/** Replays a page trace against a replacer the way the buffer pool manager drives it, returning the hit rate. */
+double ReplayTrace(Replacer *replacer, size_t pool_size, const std::vector<page_id_t> &trace) {
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  std::vector<page_id_t> frames(pool_size, INVALID_PAGE_ID);
+  size_t next_free = 0;
+  size_t hits = 0;
+  for (page_id_t page_id : trace) {
+    auto iter = page_table.find(page_id);
+    frame_id_t frame_id;
+    if (iter != page_table.end()) {
+      hits++;
+      frame_id = iter->second;
+    } else {
+      if (next_free < pool_size) {
+        frame_id = static_cast<frame_id_t>(next_free++);
+      } else {
+        EXPECT_TRUE(replacer->Victim(&frame_id));
+        page_table.erase(frames[frame_id]);
+      }
+      frames[frame_id] = page_id;
+      page_table[page_id] = frame_id;
+      replacer->RecordPage(frame_id, page_id);
+    }
+    replacer->Pin(frame_id);
+    replacer->Unpin(frame_id);
+  }
+  return static_cast<double>(hits) / trace.size();
+}
+
+}  // namespace
+
+TEST(ARCReplacerTest, SampleTest) {
+  ARCReplacer arc_replacer(3);
+
+  // Scenario: pages 10, 11 and 12 are loaded into frames 0, 1 and 2; page 10 is referenced a second time.
+  for (frame_id_t frame_id = 0; frame_id < 3; frame_id++) {
+    arc_replacer.RecordPage(frame_id, 10 + frame_id);
+    arc_replacer.Pin(frame_id);
+    arc_replacer.Unpin(frame_id);
+  }
+  arc_replacer.Pin(0);
+  arc_replacer.Unpin(0);
+  EXPECT_EQ(3, arc_replacer.Size());
+
+  // Scenario: T1 = {11, 12} is above its target size of 0, so its LRU page 11 is evicted and becomes a B1 ghost.
+  int value;
+  arc_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+
+  // Scenario: page 11 comes back. The ghost hit grows the target size of T1 and puts the page straight into T2.
+  arc_replacer.RecordPage(1, 11);
+  arc_replacer.Pin(1);
+  arc_replacer.Unpin(1);
+  EXPECT_EQ(1, arc_replacer.GetTargetT1Size());
+
+  // Scenario: T1 = {12} is no longer above target, so the LRU page of T2 (page 10 in frame 0) goes next.
+  arc_replacer.Victim(&value);
+  EXPECT_EQ(0, value);
+
+  // Scenario: pinned frames are skipped.
+  arc_replacer.Pin(2);
+  arc_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  EXPECT_EQ(false, arc_replacer.Victim(&value));
+  EXPECT_EQ(0, arc_replacer.Size());
+}
+
+// Hit rate of each policy on point lookups over a hot set, interrupted by sequential scans over cold pages.
+TEST(ARCReplacerTest, ScanPlusLookupHitRateTest) {
+  const size_t pool_size = 64;
+  const page_id_t num_hot_pages = 48;
+  const page_id_t scan_start = 1000;
+
+  std::vector<page_id_t> trace;
+  uint32_t seed = 15445;
+  page_id_t next_scan_page = scan_start;
+  for (int round = 0; round < 50; round++) {
+    for (int i = 0; i < 400; i++) {
+      trace.push_back(static_cast<page_id_t>(rand_r(&seed) % num_hot_pages));
+    }
+    for (int i = 0; i < 100; i++) {
+      trace.push_back(next_scan_page++);
+    }
+  }
+
+  std::vector<std::pair<std::string, std::unique_ptr<Replacer>>> replacers;
+  replacers.emplace_back("lru", std::make_unique<LRUReplacer>(pool_size));
+  replacers.emplace_back("clock", std::make_unique<ClockReplacer>(pool_size));
+  replacers.emplace_back("lru-2", std::make_unique<LRUKReplacer>(pool_size, 2));
+  replacers.emplace_back("arc", std::make_unique<ARCReplacer>(pool_size));
+
+  std::unordered_map<std::string, double> hit_rates;
+  for (auto &[name, replacer] : replacers) {
+    hit_rates[name] = ReplayTrace(replacer.get(), pool_size, trace);
+    std::cout << name << " hit rate: " << hit_rates[name] << std::endl;
+  }
+  EXPECT_GT(hit_rates["arc"], hit_rates["lru"]);
+  EXPECT_GT(hit_rates["arc"], hit_rates["clock"]);
+}
+
+// The same workload through the buffer pool: the lookups fetch hot pages, the scans run a table iterator over about
+// 100 pages, which reads ahead and fetches each page once per tuple. Only the hit rate of the lookups is compared; the
+// scan finds most of its pages read ahead anyway.
+// NOLINTNEXTLINE
+TEST(ARCReplacerTest, ScanPlusLookupReadAheadHitRateTest) {
+  const size_t pool_size = 64;
+  const int num_hot_pages = 48;
+
+  DiskManagerMemory disk_manager;
+  Transaction transaction(0);
+  Schema schema{std::vector<Column>{Column{"a", TypeId::VARCHAR, 1000}}};
+  Tuple tuple({Value(TypeId::VARCHAR, std::string(1000, 'x'))}, &schema);
+  page_id_t first_page_id;
+  std::vector<page_id_t> hot_pages;
+  {
+    BufferPoolManager bpm(1000, &disk_manager);
+    TableHeap table(&bpm, nullptr, nullptr, &transaction);
+    RID rid;
+    for (int i = 0; i < 400; i++) {
+      ASSERT_TRUE(table.InsertTuple(tuple, &rid, &transaction));
+    }
+    first_page_id = table.GetFirstPageId();
+    page_id_t page_id;
+    for (int i = 0; i < num_hot_pages; i++) {
+      ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+      bpm.UnpinPage(page_id, true);
+      hot_pages.push_back(page_id);
+    }
+    bpm.FlushAllPages();
+  }
+
+  std::vector<std::pair<std::string, Replacer *>> replacers;
+  replacers.emplace_back("lru", new LRUReplacer(pool_size));
+  replacers.emplace_back("clock", new ClockReplacer(pool_size));
+  replacers.emplace_back("lru-2", new LRUKReplacer(pool_size, 2, 2));
+  replacers.emplace_back("arc", new ARCReplacer(pool_size));
+
+  std::unordered_map<std::string, double> hit_rates;
+  for (auto &[name, replacer] : replacers) {
+    BufferPoolManager bpm(pool_size, &disk_manager, nullptr, replacer);
+    TableHeap table(&bpm, nullptr, nullptr, first_page_id);
+    uint32_t seed = 15445;
+    uint64_t hits = 0;
+    uint64_t lookups = 0;
+    for (int round = 0; round < 50; round++) {
+      bpm.ResetStats();
+      for (int i = 0; i < 400; i++) {
+        page_id_t page_id = hot_pages[rand_r(&seed) % num_hot_pages];
+        ASSERT_NE(nullptr, bpm.FetchPage(page_id));
+        bpm.UnpinPage(page_id, false);
+      }
+      BufferPoolStats stats = bpm.GetStats();
+      hits += stats.hits_;
+      lookups += stats.hits_ + stats.misses_;
+      int scanned = 0;
+      for (auto itr = table.Begin(&transaction); itr != table.End(); ++itr) {
+        scanned++;
+      }
+      EXPECT_EQ(400, scanned);
+    }
+    hit_rates[name] = static_cast<double>(hits) / lookups;
+    std::cout << name << " lookup hit rate: " << hit_rates[name] << std::endl;
+  }
+  EXPECT_GT(hit_rates["arc"], hit_rates["lru"]);
+  EXPECT_GT(hit_rates["arc"], hit_rates["clock"]);
+}
+
+}  // namespace bustub
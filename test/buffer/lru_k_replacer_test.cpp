@@ -0,0 +1,224 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer_test.cpp
+//
+// Identification: test/buffer/lru_k_replacer_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/lru_k_replacer.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_k_replacer(7, 2);
+
+  // Scenario: frames 1 and 2 are referenced twice, frames 3, 4 and 5 once.
+  for (frame_id_t frame_id : {1, 2, 3, 4, 5, 1, 2}) {
+    lru_k_replacer.Pin(frame_id);
+  }
+  for (frame_id_t frame_id : {1, 2, 3, 4, 5}) {
+    lru_k_replacer.Unpin(frame_id);
+  }
+  EXPECT_EQ(5, lru_k_replacer.Size());
+
+  // Scenario: frames with fewer than K references go first, oldest reference first.
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(4, value);
+
+  // Scenario: a pinned frame is not a candidate.
+  lru_k_replacer.Pin(5);
+  EXPECT_EQ(2, lru_k_replacer.Size());
+
+  // Scenario: among frames with K references, the one with the oldest K-th reference goes first.
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  EXPECT_EQ(false, lru_k_replacer.Victim(&value));
+
+  // Scenario: a victimized frame starts over with an empty history.
+  lru_k_replacer.Unpin(5);
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+}
+
+TEST(LRUKReplacerTest, CorrelatedReferenceTest) {
+  LRUKReplacer lru_k_replacer(7, 2, 2);
+
+  // Scenario: frame 1 is pinned three times in a row. The references are correlated, so it still has a single one.
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Pin(3);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Unpin(2);
+  lru_k_replacer.Unpin(3);
+
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+
+  // Scenario: frames 2 and 4 were referenced within the correlated reference period, so frame 3 goes first although
+  // the oldest reference of frame 2 is older than that of frame 3.
+  lru_k_replacer.Pin(4);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Unpin(2);
+  lru_k_replacer.Unpin(4);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+}
+
+// NOLINTNEXTLINE
+TEST(LRUKReplacerTest, CorrelatedReferencePeriodBoundaryTest) {
+  LRUKReplacer lru_k_replacer(7, 2, 2);
+
+  // Scenario: frame 1 is referenced again exactly one period after its first reference, which is a second reference.
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Pin(3);
+  lru_k_replacer.Pin(3);
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Unpin(2);
+  lru_k_replacer.Unpin(3);
+
+  // Scenario: frame 1 is also out of its period exactly one period after its last reference, unlike frame 3, so frame
+  // 2 with a single reference goes first, then frame 1, then frame 3.
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+}
+
+// NOLINTNEXTLINE
+TEST(LRUKReplacerTest, ScanResistanceTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const int num_hot_pages = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, nullptr, new LRUKReplacer(buffer_pool_size, 2));
+
+  // Scenario: the hot pages are referenced twice.
+  page_id_t page_id;
+  for (int i = 0; i < num_hot_pages; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    snprintf(bpm->GetPages()[i].GetData(), PAGE_SIZE, "hot-%d", page_id);
+    bpm->UnpinPage(page_id, true);
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    bpm->UnpinPage(page_id, false);
+  }
+
+  // Scenario: a scan goes through many more pages than the buffer pool holds.
+  for (int i = 0; i < 50; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    bpm->UnpinPage(page_id, true);
+  }
+
+  // Scenario: the hot pages survived the scan and are still resident.
+  int resident = 0;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    if (bpm->GetPages()[i].GetPageId() < num_hot_pages) {
+      resident++;
+    }
+  }
+  EXPECT_EQ(num_hot_pages, resident);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(LRUKReplacerTest, ScanResistanceReadAheadTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 16;
+  const int num_hot_pages = 5;
+
+  // Scenario: a table of about 100 pages is written out through a buffer pool that holds all of it.
+  auto *disk_manager = new DiskManager(db_name);
+  auto *transaction = new Transaction(0);
+  Schema schema{std::vector<Column>{Column{"a", TypeId::VARCHAR, 1000}}};
+  Tuple tuple({Value(TypeId::VARCHAR, std::string(1000, 'x'))}, &schema);
+  auto *load_bpm = new BufferPoolManager(200, disk_manager);
+  auto *table = new TableHeap(load_bpm, nullptr, nullptr, transaction);
+  RID rid;
+  for (int i = 0; i < 400; ++i) {
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+  }
+  page_id_t first_page_id = table->GetFirstPageId();
+  load_bpm->FlushAllPages();
+  delete table;
+  delete load_bpm;
+
+  // Scenario: in a small buffer pool, the hot pages of an index are referenced twice, far enough apart not to be
+  // correlated.
+  auto *bpm =
+      new BufferPoolManager(buffer_pool_size, disk_manager, nullptr, new LRUKReplacer(buffer_pool_size, 2, 2));
+  std::vector<page_id_t> hot_pages;
+  page_id_t page_id;
+  for (int i = 0; i < num_hot_pages; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    bpm->UnpinPage(page_id, true);
+    hot_pages.push_back(page_id);
+  }
+  for (page_id_t hot_page_id : hot_pages) {
+    ASSERT_NE(nullptr, bpm->FetchPage(hot_page_id));
+    bpm->UnpinPage(hot_page_id, false);
+  }
+
+  // Scenario: the table is scanned with read-ahead. The scan fetches a page once per tuple in a row, which is a single
+  // correlated reference; reading the page ahead and flushing it are no references at all. Every table page therefore
+  // goes before the hot pages.
+  table = new TableHeap(bpm, nullptr, nullptr, first_page_id);
+  int scanned = 0;
+  for (auto itr = table->Begin(transaction); itr != table->End(); ++itr) {
+    scanned++;
+  }
+  EXPECT_EQ(400, scanned);
+  bpm->FlushAllPages();
+
+  // Scenario: the hot pages survived the scan and are still resident.
+  int resident = 0;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    if (std::count(hot_pages.begin(), hot_pages.end(), bpm->GetPages()[i].GetPageId()) > 0) {
+      resident++;
+    }
+  }
+  EXPECT_EQ(num_hot_pages, resident);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete table;
+  delete bpm;
+  delete transaction;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -19,7 +19,7 @@
 
 namespace bustub {
 
-TEST(LRUReplacerTest, DISABLED_SampleTest) {
+TEST(LRUReplacerTest, SampleTest) {
   LRUReplacer lru_replacer(7);
 
   // Scenario: unpin six elements, i.e. add them to the replacer.
@@ -50,6 +50,12 @@ TEST(LRUReplacerTest, DISABLED_SampleTest) {
   // Scenario: unpin 4. We expect that the reference bit of 4 will be set to 1.
   lru_replacer.Unpin(4);
 
+  // Scenario: peek at the upcoming victims without evicting them.
+  std::vector<frame_id_t> frames;
+  lru_replacer.PeekVictims(2, &frames);
+  EXPECT_EQ(std::vector<frame_id_t>({5, 6}), frames);
+  EXPECT_EQ(3, lru_replacer.Size());
+
   // Scenario: continue looking for victims. We expect these victims.
   lru_replacer.Victim(&value);
   EXPECT_EQ(5, value);
@@ -0,0 +1,161 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_trace_test.cpp
+//
+// Identification: test/buffer/page_trace_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/page_trace.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PageTraceTest, ReadWriteTest) {
+  const std::string trace_file = "test.trace";
+  std::vector<PageAccess> accesses{
+      {0, PageAccessType::NEW},       {1, PageAccessType::FETCH}, {2, PageAccessType::FETCH},
+      {1000000, PageAccessType::FETCH}, {3, PageAccessType::NEW},   {3, PageAccessType::FETCH},
+      {INT32_MAX, PageAccessType::FETCH}, {0, PageAccessType::FETCH}};
+  {
+    PageTraceWriter writer(trace_file);
+    for (const auto &access : accesses) {
+      writer.Record(access.page_id_, access.type_);
+    }
+    EXPECT_EQ(accesses.size(), writer.GetNumRecords());
+  }
+
+  auto read = PageTraceReader::ReadAll(trace_file);
+  ASSERT_EQ(accesses.size(), read.size());
+  for (size_t i = 0; i < accesses.size(); i++) {
+    EXPECT_EQ(accesses[i].page_id_, read[i].page_id_);
+    EXPECT_EQ(accesses[i].type_, read[i].type_);
+  }
+
+  // Scenario: a sequential scan costs one byte per page after the magic.
+  {
+    PageTraceWriter writer(trace_file);
+    for (const auto &access : PageTraceGenerator::Loop(1000, 1000)) {
+      writer.Record(access.page_id_, access.type_);
+    }
+  }
+  FILE *file = fopen(trace_file.c_str(), "rb");
+  ASSERT_NE(nullptr, file);
+  fseek(file, 0, SEEK_END);
+  EXPECT_EQ(8 + 1000, ftell(file));
+  fclose(file);
+
+  // Scenario: a trace of many buffers, written by the writer thread, reads back in order, a flush in between or not.
+  accesses = PageTraceGenerator::Zipfian(100000, 200000, 0.5);
+  {
+    PageTraceWriter writer(trace_file);
+    for (size_t i = 0; i < accesses.size(); i++) {
+      writer.Record(accesses[i].page_id_, accesses[i].type_);
+      if (i == accesses.size() / 2) {
+        writer.Flush();
+      }
+    }
+  }
+  read = PageTraceReader::ReadAll(trace_file);
+  ASSERT_EQ(accesses.size(), read.size());
+  for (size_t i = 0; i < accesses.size(); i++) {
+    ASSERT_EQ(accesses[i].page_id_, read[i].page_id_);
+  }
+
+  remove(trace_file.c_str());
+  EXPECT_THROW(PageTraceReader reader(trace_file), Exception);
+}
+
+// NOLINTNEXTLINE
+TEST(PageTraceTest, BufferPoolTraceTest) {
+  const std::string trace_file = "test.trace";
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(5, disk_manager);
+
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+
+  // Scenario: only the accesses between StartTrace and StopTrace are recorded, hits and misses alike.
+  bpm->StartTrace(trace_file);
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  for (page_id_t fetched : {0, 1, 0}) {
+    ASSERT_NE(nullptr, bpm->FetchPage(fetched));
+    EXPECT_EQ(true, bpm->UnpinPage(fetched, false));
+  }
+  bpm->StopTrace();
+  ASSERT_NE(nullptr, bpm->FetchPage(1));
+  EXPECT_EQ(true, bpm->UnpinPage(1, false));
+
+  auto read = PageTraceReader::ReadAll(trace_file);
+  ASSERT_EQ(4, read.size());
+  EXPECT_EQ(1, read[0].page_id_);
+  EXPECT_EQ(PageAccessType::NEW, read[0].type_);
+  EXPECT_EQ(0, read[1].page_id_);
+  EXPECT_EQ(1, read[2].page_id_);
+  EXPECT_EQ(0, read[3].page_id_);
+  EXPECT_EQ(PageAccessType::FETCH, read[3].type_);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove(trace_file.c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(PageTraceTest, GeneratorTest) {
+  // Scenario: a skewed Zipfian trace concentrates on a few pages, a uniform one does not.
+  auto CountTop = [](const std::vector<PageAccess> &trace, size_t num_pages, size_t top) {
+    std::vector<size_t> counts(num_pages);
+    for (const auto &access : trace) {
+      counts[access.page_id_]++;
+    }
+    std::sort(counts.rbegin(), counts.rend());
+    size_t sum = 0;
+    for (size_t i = 0; i < top; i++) {
+      sum += counts[i];
+    }
+    return sum;
+  };
+  auto skewed = PageTraceGenerator::Zipfian(1000, 100000, 0.99);
+  auto uniform = PageTraceGenerator::Zipfian(1000, 100000, 0);
+  ASSERT_EQ(100000, skewed.size());
+  EXPECT_GT(CountTop(skewed, 1000, 100), 50000);
+  EXPECT_LT(CountTop(uniform, 1000, 100), 20000);
+
+  // Scenario: the scans of a scan trace never revisit a page.
+  auto scan = PageTraceGenerator::Scan(10, 50, 20, 700);
+  ASSERT_EQ(700, scan.size());
+  std::set<page_id_t> scanned;
+  for (size_t i = 0; i < scan.size(); i++) {
+    if (i % 70 < 20) {
+      EXPECT_LT(scan[i].page_id_, 10);
+    } else {
+      EXPECT_TRUE(scanned.insert(scan[i].page_id_).second);
+      EXPECT_GE(scan[i].page_id_, 10);
+    }
+  }
+
+  // Scenario: a loop trace reads its pages in order, over and over.
+  auto loop = PageTraceGenerator::Loop(7, 30);
+  ASSERT_EQ(30, loop.size());
+  for (size_t i = 0; i < loop.size(); i++) {
+    EXPECT_EQ(static_cast<page_id_t>(i % 7), loop[i].page_id_);
+  }
+}
+
+}  // namespace bustub
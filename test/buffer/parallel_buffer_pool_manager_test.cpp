@@ -0,0 +1,208 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/parallel_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const std::string db_name = "test.db";
+  const size_t num_instances = 5;
+  const size_t instance_pool_size = 2;
+  const size_t buffer_pool_size = num_instances * instance_pool_size;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, instance_pool_size, disk_manager);
+  EXPECT_EQ(buffer_pool_size, bpm->GetPoolSize());
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+
+  // Scenario: The buffer pool is empty. We should be able to create a new page.
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+  snprintf(page0->GetData(), PAGE_SIZE, "Hello");
+
+  // Scenario: New pages are spread over the instances, so we can fill every frame.
+  for (size_t i = 1; i < buffer_pool_size; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  // Scenario: Unpinning a single page frees exactly one frame, which a new page must find in its instance.
+  EXPECT_EQ(true, bpm->UnpinPage(3, true));
+  auto *page = bpm->NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(bpm->GetInstance(3), bpm->GetInstance(page_id_temp));
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+
+  // Scenario: We should be able to fetch the data we wrote a while ago after it was evicted.
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  // Scenario: Deleting an unpinned page succeeds, deleting a pinned one fails.
+  EXPECT_EQ(true, bpm->DeletePage(0));
+  EXPECT_EQ(false, bpm->DeletePage(1));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, NewPageSpreadTest) {
+  const std::string db_name = "test.db";
+  const size_t num_instances = 4;
+  const size_t instance_pool_size = 2;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, instance_pool_size, disk_manager);
+  // Only the ids of instance 3 are free, as after its pages were deleted.
+  for (page_id_t page_id = 0; page_id < 24; page_id++) {
+    disk_manager->AllocatePage();
+  }
+  for (page_id_t page_id = 3; page_id < 24; page_id += num_instances) {
+    disk_manager->DeallocatePage(page_id);
+  }
+
+  // Scenario: new pages still go to every instance in turn, so every frame can be filled.
+  std::vector<size_t> instance_pages(num_instances);
+  for (size_t i = 0; i < num_instances * instance_pool_size; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    instance_pages[page_id % num_instances]++;
+  }
+  for (size_t pages : instance_pages) {
+    EXPECT_EQ(instance_pool_size, pages);
+  }
+  page_id_t page_id;
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ConcurrencyTest) {
+  const std::string db_name = "test.db";
+  const int num_threads = 8;
+  const int pages_per_thread = 50;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(4, 16, disk_manager);
+
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([bpm, tid] {
+      std::vector<page_id_t> page_ids;
+      for (int i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id;
+        auto *page = bpm->NewPage(&page_id);
+        ASSERT_NE(nullptr, page);
+        snprintf(page->GetData(), PAGE_SIZE, "%d-%d", tid, page_id);
+        EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+        page_ids.push_back(page_id);
+      }
+      for (auto page_id : page_ids) {
+        auto *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(std::to_string(tid) + "-" + std::to_string(page_id), std::string(page->GetData()));
+        EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// Fetch throughput of resident pages from 1 to 32 threads, for a single pool and a sharded pool of equal size.
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, FetchScalingTest) {
+  const std::string db_name = "test.db";
+  const size_t num_pages = 256;
+  const int fetches_per_thread = 20000;
+
+  auto *disk_manager = new DiskManager(db_name);
+  std::vector<std::pair<std::string, BufferPoolManager *>> pools = {
+      {"single", new BufferPoolManager(num_pages, disk_manager)},
+      {"parallel-16", new ParallelBufferPoolManager(16, num_pages / 16, disk_manager)}};
+
+  for (auto &[name, bpm] : pools) {
+    std::vector<page_id_t> page_ids;
+    for (size_t i = 0; i < num_pages; i++) {
+      page_id_t page_id;
+      ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+      bpm->UnpinPage(page_id, false);
+      page_ids.push_back(page_id);
+    }
+
+    for (int num_threads = 1; num_threads <= 32; num_threads *= 2) {
+      std::vector<std::thread> threads;
+      auto start = std::chrono::steady_clock::now();
+      for (int tid = 0; tid < num_threads; tid++) {
+        threads.emplace_back([bpm = bpm, &page_ids, tid] {
+          uint32_t seed = tid;
+          for (int i = 0; i < fetches_per_thread; i++) {
+            page_id_t page_id = page_ids[rand_r(&seed) % page_ids.size()];
+            auto *page = bpm->FetchPage(page_id);
+            ASSERT_NE(nullptr, page);
+            bpm->UnpinPage(page_id, false);
+          }
+        });
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      std::cout << name << " threads=" << num_threads
+                << " fetches/sec=" << static_cast<uint64_t>(num_threads * fetches_per_thread / elapsed) << std::endl;
+    }
+  }
+
+  for (auto &[name, bpm] : pools) {
+    delete bpm;
+  }
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// crc32c_test.cpp
+//
+// Identification: test/common/crc32c_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "common/util/crc32c.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(Crc32cTest, KnownValueTest) {
+  // The check value of CRC-32C.
+  EXPECT_EQ(0xE3069283, Crc32c::Compute("123456789", 9));
+  EXPECT_EQ(0xE3069283, Crc32c::ComputeSoftware("123456789", 9));
+  EXPECT_EQ(0, Crc32c::Compute("", 0));
+
+  // 32 bytes of zeros, from the test vectors of RFC 3720.
+  std::vector<char> zeros(32, 0);
+  EXPECT_EQ(0x8A9136AA, Crc32c::Compute(zeros.data(), zeros.size()));
+}
+
+// NOLINTNEXTLINE
+TEST(Crc32cTest, HardwareMatchesSoftwareTest) {
+  std::mt19937 rng(15445);
+  std::vector<char> data(3 * 4096 + 64);
+  for (auto &byte : data) {
+    byte = static_cast<char>(rng());
+  }
+
+  // Scenario: every length and alignment, around the block sizes of the interleaved streams.
+  for (size_t size : {0, 1, 7, 8, 9, 63, 255, 256, 767, 768, 769, 1000, 4092, 4096, 3 * 4096}) {
+    for (size_t offset = 0; offset < 8; offset++) {
+      ASSERT_EQ(Crc32c::ComputeSoftware(data.data() + offset, size), Crc32c::Compute(data.data() + offset, size))
+          << "size " << size << " offset " << offset;
+    }
+  }
+
+  // Scenario: a buffer checksummed in pieces has the checksum of the whole.
+  uint32_t whole = Crc32c::Compute(data.data(), 4096);
+  uint32_t crc = 0;
+  for (size_t start = 0; start < 4096; start += 1000) {
+    crc = Crc32c::Compute(data.data() + start, std::min<size_t>(1000, 4096 - start), crc);
+  }
+  EXPECT_EQ(whole, crc);
+  EXPECT_EQ(whole, Crc32c::ComputeSoftware(data.data() + 100, 3996, Crc32c::ComputeSoftware(data.data(), 100)));
+
+  // Scenario: a single flipped bit changes the checksum.
+  data[2000] ^= 1;
+  EXPECT_NE(whole, Crc32c::Compute(data.data(), 4096));
+}
+
+}  // namespace bustub
@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lz_codec_test.cpp
+//
+// Identification: test/common/lz_codec_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/util/lz_codec.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/** Compresses and decompresses data, expecting the round trip to give it back. @return the compressed size */
+static size_t RoundTrip(const std::vector<char> &data) {
+  std::vector<char> compressed(data.size() + data.size() / 128 + 16);
+  size_t size = LZCodec::Compress(data.data(), data.size(), compressed.data(), compressed.size());
+  EXPECT_NE(0, size);
+  std::vector<char> decompressed(data.size());
+  EXPECT_TRUE(LZCodec::Decompress(compressed.data(), size, decompressed.data(), decompressed.size()));
+  EXPECT_EQ(data, decompressed);
+  return size;
+}
+
+// NOLINTNEXTLINE
+TEST(LZCodecTest, RoundTripTest) {
+  std::mt19937 rng(15445);
+
+  // Scenario: empty, tiny and noise-only inputs survive as literals.
+  EXPECT_EQ(1, RoundTrip({}));
+  RoundTrip({'a', 'b', 'c'});
+  std::vector<char> noise(4096);
+  for (auto &byte : noise) {
+    byte = static_cast<char>(rng());
+  }
+  RoundTrip(noise);
+
+  // Scenario: runs of one byte and long matches need extra length bytes and overlapping copies.
+  EXPECT_LT(RoundTrip(std::vector<char>(65536, '\0')), 300);
+  std::vector<char> runs;
+  for (int i = 0; i < 100; i++) {
+    runs.insert(runs.end(), i * 7 % 300, static_cast<char>(i));
+    runs.insert(runs.end(), noise.begin(), noise.begin() + i % 20);
+  }
+  RoundTrip(runs);
+
+  // Scenario: rows of integers and short strings, like a table page, compress to less than half.
+  std::vector<char> rows;
+  for (int i = 0; rows.size() < 4000; i++) {
+    char row[32];
+    int length = snprintf(row, sizeof(row), "%c%c%c%ccustomer_%d", i, 0, 0, 0, i % 50);
+    rows.insert(rows.end(), row, row + length);
+  }
+  EXPECT_LT(RoundTrip(rows), rows.size() / 2);
+}
+
+// NOLINTNEXTLINE
+TEST(LZCodecTest, CapacityAndCorruptionTest) {
+  std::vector<char> data(4096);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<char>(i * i % 251);
+  }
+  std::vector<char> compressed(8192);
+  size_t size = LZCodec::Compress(data.data(), data.size(), compressed.data(), compressed.size());
+  ASSERT_NE(0, size);
+
+  // Scenario: output that does not fit is reported instead of written past the buffer.
+  EXPECT_EQ(0, LZCodec::Compress(data.data(), data.size(), compressed.data(), size - 1));
+  EXPECT_EQ(size, LZCodec::Compress(data.data(), data.size(), compressed.data(), size));
+
+  // Scenario: truncated input, a wrong size and garbage are rejected without overflowing the output.
+  std::vector<char> out(data.size());
+  EXPECT_FALSE(LZCodec::Decompress(compressed.data(), size / 2, out.data(), out.size()));
+  EXPECT_FALSE(LZCodec::Decompress(compressed.data(), size, out.data(), out.size() - 1));
+  std::mt19937 rng(15445);
+  for (int i = 0; i < 1000; i++) {
+    std::vector<char> garbage(compressed.begin(), compressed.begin() + size);
+    garbage[rng() % size] = static_cast<char>(rng());
+    LZCodec::Decompress(garbage.data(), garbage.size(), out.data(), out.size());
+  }
+}
+
+}  // namespace bustub
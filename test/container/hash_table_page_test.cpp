@@ -70,6 +70,7 @@ TEST(HashTablePageTest, DISABLED_BlockPageSampleTest) {
 
   auto block_page =
       reinterpret_cast<HashTableBlockPage<int, int, IntComparator> *>(bpm->NewPage(&block_page_id, nullptr)->GetData());
+  block_page->Init(bpm->GetUsablePageSize());
 
   // insert a few (key, value) pairs
   for (unsigned i = 0; i < 10; i++) {
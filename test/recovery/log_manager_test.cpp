@@ -0,0 +1,226 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_manager_test.cpp
+//
+// Identification: test/recovery/log_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "gtest/gtest.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+/** Reads the log back and checks that it holds the records of lsn 0 to num_records - 1 in order. */
+static void CheckLog(DiskManager *disk_manager, int num_records) {
+  std::vector<char> log(LOG_BUFFER_SIZE);
+  int64_t offset = disk_manager->GetLogBegin();
+  lsn_t next_lsn = 0;
+  while (disk_manager->ReadLog(log.data(), LOG_BUFFER_SIZE, offset)) {
+    int pos = 0;
+    int32_t size;
+    while (pos + 8 <= LOG_BUFFER_SIZE && (memcpy(&size, &log[pos], sizeof(size)), size > 0) &&
+           pos + size <= LOG_BUFFER_SIZE) {
+      lsn_t lsn;
+      memcpy(&lsn, &log[pos + 4], sizeof(lsn));
+      ASSERT_EQ(next_lsn, lsn);
+      next_lsn++;
+      pos += size;
+    }
+    if (pos == 0) {
+      break;
+    }
+    offset += pos;
+  }
+  EXPECT_EQ(num_records, next_lsn);
+}
+
+// NOLINTNEXTLINE
+TEST(LogManagerTest, GroupCommitTest) {
+  const int num_threads = 16;
+  const int commits_per_thread = 50;
+  std::string db_file("test.db");
+  auto window = log_group_commit_window;
+  {
+    DiskManager disk_manager(db_file);
+    LogManager log_manager(&disk_manager);
+    log_manager.RunFlushThread();
+    EXPECT_TRUE(enable_logging);
+
+    // Scenario: every commit returns once its record is durable, and concurrent commits share flushes.
+    log_group_commit_window = std::chrono::milliseconds(1);
+    std::vector<std::thread> threads;
+    std::atomic<int> not_durable{0};
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t] {
+        for (int i = 0; i < commits_per_thread; i++) {
+          LogRecord log_record(t, INVALID_LSN, LogRecordType::COMMIT);
+          lsn_t lsn = log_manager.AppendLogRecord(&log_record);
+          log_manager.WaitForFlush(lsn);
+          not_durable += log_manager.GetPersistentLSN() < lsn ? 1 : 0;
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(0, not_durable);
+    EXPECT_EQ(num_threads * commits_per_thread - 1, log_manager.GetPersistentLSN());
+    EXPECT_LT(disk_manager.GetNumFlushes(), num_threads * commits_per_thread / 2);
+
+    // Scenario: without a window, the committing threads write the log themselves and still share flushes.
+    log_group_commit_window = std::chrono::microseconds(0);
+    int num_flushes = disk_manager.GetNumFlushes();
+    threads.clear();
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t] {
+        for (int i = 0; i < commits_per_thread; i++) {
+          LogRecord log_record(t, INVALID_LSN, LogRecordType::COMMIT);
+          lsn_t lsn = log_manager.AppendLogRecord(&log_record);
+          log_manager.WaitForFlush(lsn);
+          not_durable += log_manager.GetPersistentLSN() < lsn ? 1 : 0;
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(0, not_durable);
+    EXPECT_EQ(2 * num_threads * commits_per_thread - 1, log_manager.GetPersistentLSN());
+    EXPECT_LT(disk_manager.GetNumFlushes() - num_flushes, num_threads * commits_per_thread / 2);
+
+    // Scenario: records that overflow the log buffer are flushed without anyone waiting for them.
+    int num_records = 2 * num_threads * commits_per_thread;
+    for (; num_records < 2 * num_threads * commits_per_thread + 3 * LOG_BUFFER_SIZE / 20; num_records++) {
+      LogRecord log_record(0, INVALID_LSN, LogRecordType::BEGIN);
+      log_manager.AppendLogRecord(&log_record);
+    }
+    EXPECT_GE(log_manager.GetPersistentLSN(), 2 * num_threads * commits_per_thread + LOG_BUFFER_SIZE / 20);
+
+    // Scenario: stopping the flush thread flushes the rest of the log.
+    log_manager.StopFlushThread();
+    EXPECT_FALSE(enable_logging);
+    EXPECT_EQ(num_records - 1, log_manager.GetPersistentLSN());
+    CheckLog(&disk_manager, num_records);
+
+    // Scenario: without a flush thread, the committing thread flushes the log itself.
+    LogRecord log_record(0, INVALID_LSN, LogRecordType::COMMIT);
+    lsn_t lsn = log_manager.AppendLogRecord(&log_record);
+    log_manager.WaitForFlush(lsn);
+    EXPECT_EQ(lsn, log_manager.GetPersistentLSN());
+    CheckLog(&disk_manager, num_records + 1);
+    disk_manager.ShutDown();
+  }
+  log_group_commit_window = window;
+  remove(db_file.c_str());
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(LogManagerTest, TruncateLogTest) {
+  DiskManagerMemory disk_manager;
+  LogManager log_manager(&disk_manager);
+
+  // Scenario: truncation releases the log that was flushed and keeps the records that are still buffered.
+  LogRecord begin_record(0, INVALID_LSN, LogRecordType::BEGIN);
+  log_manager.WaitForFlush(log_manager.AppendLogRecord(&begin_record));
+  LogRecord commit_record(0, INVALID_LSN, LogRecordType::COMMIT);
+  lsn_t lsn = log_manager.AppendLogRecord(&commit_record);
+  log_manager.TruncateLog();
+  EXPECT_EQ(begin_record.GetSize(), disk_manager.GetLogBegin());
+  log_manager.WaitForFlush(lsn);
+  EXPECT_EQ(begin_record.GetSize() + commit_record.GetSize(), disk_manager.GetLogSize());
+
+  std::vector<char> log(LOG_BUFFER_SIZE);
+  EXPECT_FALSE(disk_manager.ReadLog(log.data(), LOG_BUFFER_SIZE, 0));
+  ASSERT_TRUE(disk_manager.ReadLog(log.data(), LOG_BUFFER_SIZE, disk_manager.GetLogBegin()));
+  lsn_t first_lsn;
+  memcpy(&first_lsn, &log[4], sizeof(first_lsn));
+  EXPECT_EQ(lsn, first_lsn);
+}
+
+// Measures the commit rate with one log flush per commit and with group commit, at 1 to 64 committing threads.
+// Run with --gtest_also_run_disabled_tests.
+// NOLINTNEXTLINE
+TEST(LogManagerTest, DISABLED_GroupCommitBenchmark) {
+  const auto duration = std::chrono::seconds(1);
+  std::string db_file("test.db");
+  DiskManager disk_manager(db_file);
+
+  // Runs commit in num_threads threads for a while. @return commits per second
+  auto commits_per_second = [&](int num_threads, const std::function<void(txn_id_t)> &commit) {
+    std::atomic<bool> done{false};
+    std::atomic<int> commits{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t] {
+        while (!done) {
+          commit(t);
+          commits++;
+        }
+      });
+    }
+    std::this_thread::sleep_for(duration);
+    done = true;
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    return commits / std::chrono::duration<double>(duration).count();
+  };
+
+  // One flush per commit: every commit writes and syncs its own record.
+  std::mutex latch;
+  std::vector<char> buffers[2] = {std::vector<char>(LOG_BUFFER_SIZE), std::vector<char>(LOG_BUFFER_SIZE)};
+  int next_buffer = 0;
+  auto flush_per_commit = [&](txn_id_t txn_id) {
+    std::scoped_lock lock{latch};
+    LogRecord log_record(txn_id, INVALID_LSN, LogRecordType::COMMIT);
+    memcpy(buffers[next_buffer].data(), &log_record, log_record.GetSize());
+    disk_manager.WriteLog(buffers[next_buffer].data(), log_record.GetSize());
+    next_buffer ^= 1;
+  };
+
+  LogManager log_manager(&disk_manager);
+  log_manager.RunFlushThread();
+  auto group_commit = [&](txn_id_t txn_id) {
+    LogRecord log_record(txn_id, INVALID_LSN, LogRecordType::COMMIT);
+    log_manager.WaitForFlush(log_manager.AppendLogRecord(&log_record));
+  };
+
+  auto window = log_group_commit_window;
+  std::cout << "threads  per-commit flush  group commit  group commit (100 us window)  [commits/s]" << std::endl;
+  for (int num_threads = 1; num_threads <= 64; num_threads *= 2) {
+    double single = commits_per_second(num_threads, flush_per_commit);
+    log_group_commit_window = std::chrono::microseconds(0);
+    double group = commits_per_second(num_threads, group_commit);
+    log_group_commit_window = std::chrono::microseconds(100);
+    double windowed = commits_per_second(num_threads, group_commit);
+    log_group_commit_window = window;
+    std::cout << num_threads << "\t " << single << "\t\t   " << group << "\t " << windowed << std::endl;
+  }
+
+  log_manager.StopFlushThread();
+  disk_manager.ShutDown();
+  remove(db_file.c_str());
+  remove("test.log");
+}
+
+}  // namespace bustub
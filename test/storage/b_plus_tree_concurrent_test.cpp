@@ -2,6 +2,7 @@
  * b_plus_tree_test.cpp
  */
 
+#include <atomic>
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
@@ -92,7 +93,7 @@ void DeleteHelperSplit(BPlusTree<GenericKey<8>, RID, GenericComparator<8>> *tree
   delete transaction;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest1) {
+TEST(BPlusTreeConcurrentTest, InsertTest1) {
   // create KeyComparator and index schema
   Schema *key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema);
@@ -139,13 +140,13 @@ TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest1) {
 
   bpm->UnpinPage(HEADER_PAGE_ID, true);
   delete key_schema;
-  delete disk_manager;
   delete bpm;
+  delete disk_manager;
   remove("test.db");
   remove("test.log");
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest2) {
+TEST(BPlusTreeConcurrentTest, InsertTest2) {
   // create KeyComparator and index schema
   Schema *key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema);
@@ -191,13 +192,13 @@ TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest2) {
 
   bpm->UnpinPage(HEADER_PAGE_ID, true);
   delete key_schema;
-  delete disk_manager;
   delete bpm;
+  delete disk_manager;
   remove("test.db");
   remove("test.log");
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest1) {
+TEST(BPlusTreeConcurrentTest, DeleteTest1) {
   // create KeyComparator and index schema
   Schema *key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema);
@@ -234,13 +235,13 @@ TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest1) {
 
   bpm->UnpinPage(HEADER_PAGE_ID, true);
   delete key_schema;
-  delete disk_manager;
   delete bpm;
+  delete disk_manager;
   remove("test.db");
   remove("test.log");
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest2) {
+TEST(BPlusTreeConcurrentTest, DeleteTest2) {
   // create KeyComparator and index schema
   Schema *key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema);
@@ -278,13 +279,13 @@ TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest2) {
 
   bpm->UnpinPage(HEADER_PAGE_ID, true);
   delete key_schema;
-  delete disk_manager;
   delete bpm;
+  delete disk_manager;
   remove("test.db");
   remove("test.log");
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_MixTest) {
+TEST(BPlusTreeConcurrentTest, MixTest) {
   // create KeyComparator and index schema
   Schema *key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema);
@@ -324,8 +325,235 @@ TEST(BPlusTreeConcurrentTest, DISABLED_MixTest) {
 
   bpm->UnpinPage(HEADER_PAGE_ID, true);
   delete key_schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// Concurrent inserts and deletes in small pages, so that threads keep splitting and merging the same pages.
+TEST(BPlusTreeConcurrentTest, SmallPageMixTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 4);
+  GenericKey<8> index_key;
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int total_threads = 8;
+  std::vector<int64_t> keys;
+  std::vector<int64_t> remove_keys;
+  for (int64_t key = 1; key <= 4000; key++) {
+    keys.push_back(key);
+    if (key % 2 == 1) {
+      remove_keys.push_back(key);
+    }
+  }
+  LaunchParallelTest(total_threads, InsertHelperSplit, &tree, keys, total_threads);
+  LaunchParallelTest(total_threads, DeleteHelperSplit, &tree, remove_keys, total_threads);
+
+  std::vector<RID> rids;
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(key % 2 == 0, tree.GetValue(index_key, &rids));
+  }
+
+  int64_t current_key = 2;
+  for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key = current_key + 2;
+  }
+  EXPECT_EQ(current_key, 4002);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// Lookups read internal pages without latches; they must still see every key while writers split and merge pages.
+TEST(BPlusTreeConcurrentTest, OptimisticReadTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 4);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // The even keys stay in the tree, the odd keys come and go.
+  const int total_threads = 4;
+  std::vector<int64_t> stable_keys;
+  std::vector<int64_t> moving_keys;
+  for (int64_t key = 1; key <= 2000; key++) {
+    (key % 2 == 0 ? stable_keys : moving_keys).push_back(key);
+  }
+  InsertHelper(&tree, stable_keys);
+
+  std::atomic<int> missing{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < total_threads; i++) {
+    threads.emplace_back([&, i] {
+      InsertHelperSplit(&tree, moving_keys, total_threads, i);
+      DeleteHelperSplit(&tree, moving_keys, total_threads, i);
+    });
+    threads.emplace_back([&] {
+      GenericKey<8> index_key;
+      std::vector<RID> rids;
+      for (int round = 0; round < 3; round++) {
+        for (auto key : stable_keys) {
+          rids.clear();
+          index_key.SetFromInteger(key);
+          if (!tree.GetValue(index_key, &rids) || rids[0].GetSlotNum() != key) {
+            missing++;
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, missing);
+
+  int64_t current_key = 2;
+  for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key = current_key + 2;
+  }
+  EXPECT_EQ(current_key, 2002);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete bpm;
   delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// Merges delete pages that lookups may have pinned on their way down; those pages must still be deallocated.
+TEST(BPlusTreeConcurrentTest, OptimisticReadDeleteTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 4);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int total_threads = 4;
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 1000; key++) {
+    keys.push_back(key);
+  }
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < total_threads; i++) {
+    readers.emplace_back([&] {
+      GenericKey<8> index_key;
+      std::vector<RID> rids;
+      while (!done) {
+        for (auto key : keys) {
+          rids.clear();
+          index_key.SetFromInteger(key);
+          tree.GetValue(index_key, &rids);
+        }
+      }
+    });
+  }
+  // Every round grows the tree and then removes every key, which deletes all of its pages.
+  for (int round = 0; round < 10; round++) {
+    LaunchParallelTest(total_threads, InsertHelperSplit, &tree, keys, total_threads);
+    LaunchParallelTest(total_threads, DeleteHelperSplit, &tree, keys, total_threads);
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+  for (page_id = HEADER_PAGE_ID + 1; page_id < 10000; page_id++) {
+    ASSERT_FALSE(disk_manager->IsPageAllocated(page_id)) << "page " << page_id;
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
   delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// With swizzling, descents follow frame hints that go stale as the small pool evicts and reuses frames.
+TEST(BPlusTreeConcurrentTest, SwizzledMixTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 4);
+  tree.SetSwizzling(true);
+  GenericKey<8> index_key;
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int total_threads = 8;
+  std::vector<int64_t> keys;
+  std::vector<int64_t> remove_keys;
+  for (int64_t key = 1; key <= 4000; key++) {
+    keys.push_back(key);
+    if (key % 2 == 1) {
+      remove_keys.push_back(key);
+    }
+  }
+  LaunchParallelTest(total_threads, InsertHelperSplit, &tree, keys, total_threads);
+  LaunchParallelTest(total_threads, DeleteHelperSplit, &tree, remove_keys, total_threads);
+
+  std::vector<RID> rids;
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(key % 2 == 0, tree.GetValue(index_key, &rids));
+  }
+
+  int64_t current_key = 2;
+  for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key = current_key + 2;
+  }
+  EXPECT_EQ(current_key, 4002);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete bpm;
+  delete disk_manager;
   remove("test.db");
   remove("test.log");
 }
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
 
 #include "b_plus_tree_test_util.h"  // NOLINT
 #include "buffer/buffer_pool_manager.h"
@@ -12,7 +13,7 @@
 
 namespace bustub {
 
-TEST(BPlusTreeTests, DISABLED_DeleteTest1) {
+TEST(BPlusTreeTests, DeleteTest1) {
   // create KeyComparator and index schema
   std::string createStmt = "a bigint";
   Schema *key_schema = ParseCreateStatement(createStmt);
@@ -86,13 +87,13 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest1) {
   bpm->UnpinPage(HEADER_PAGE_ID, true);
   delete key_schema;
   delete transaction;
-  delete disk_manager;
   delete bpm;
+  delete disk_manager;
   remove("test.db");
   remove("test.log");
 }
 
-TEST(BPlusTreeTests, DISABLED_DeleteTest2) {
+TEST(BPlusTreeTests, DeleteTest2) {
   // create KeyComparator and index schema
   Schema *key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema);
@@ -165,8 +166,82 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest2) {
   bpm->UnpinPage(HEADER_PAGE_ID, true);
   delete key_schema;
   delete transaction;
+  delete bpm;
   delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// Many keys in small pages: splits, merges and redistributions at every level, and long leaf chains to read ahead.
+TEST(BPlusTreeTests, ScaleTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 4);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t scale = 2000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= scale; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+  index_key.SetFromInteger(keys[0]);
+  EXPECT_FALSE(tree.Insert(index_key, rid, transaction));
+
+  // remove the odd keys
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15721));
+  for (auto key : keys) {
+    if (key % 2 == 1) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, transaction);
+    }
+  }
+
+  std::vector<RID> rids;
+  for (int64_t key = 1; key <= scale; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(key % 2 == 0, tree.GetValue(index_key, &rids));
+  }
+
+  int64_t current_key = 2;
+  for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key = current_key + 2;
+  }
+  EXPECT_EQ(current_key, scale + 2);
+
+  // remove the rest, the tree ends up empty
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+  EXPECT_TRUE(tree.begin() == tree.end());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
   delete bpm;
+  delete disk_manager;
   remove("test.db");
   remove("test.log");
 }
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
 
 #include "b_plus_tree_test_util.h"  // NOLINT
 #include "buffer/buffer_pool_manager.h"
@@ -12,7 +13,7 @@
 
 namespace bustub {
 
-TEST(BPlusTreeTests, DISABLED_InsertTest1) {
+TEST(BPlusTreeTests, InsertTest1) {
   // create KeyComparator and index schema
   Schema *key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema);
@@ -65,13 +66,13 @@ TEST(BPlusTreeTests, DISABLED_InsertTest1) {
   bpm->UnpinPage(HEADER_PAGE_ID, true);
   delete key_schema;
   delete transaction;
-  delete disk_manager;
   delete bpm;
+  delete disk_manager;
   remove("test.db");
   remove("test.log");
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest2) {
+TEST(BPlusTreeTests, InsertTest2) {
   // create KeyComparator and index schema
   Schema *key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema);
@@ -134,9 +135,67 @@ TEST(BPlusTreeTests, DISABLED_InsertTest2) {
   bpm->UnpinPage(HEADER_PAGE_ID, true);
   delete key_schema;
   delete transaction;
-  delete disk_manager;
   delete bpm;
+  delete disk_manager;
   remove("test.db");
   remove("test.log");
 }
+
+// With the default max sizes the nodes fill the pages, whatever the page size of the database file.
+TEST(BPlusTreeTests, PageSizeInsertTest) {
+  for (size_t page_size : {static_cast<size_t>(MIN_PAGE_SIZE), static_cast<size_t>(MAX_PAGE_SIZE)}) {
+    // create KeyComparator and index schema
+    Schema *key_schema = ParseCreateStatement("a bigint");
+    GenericComparator<8> comparator(key_schema);
+
+    DiskManager *disk_manager = new DiskManager("test.db", page_size);
+    BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+    // create b+ tree
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+    GenericKey<8> index_key;
+    RID rid;
+    // create transaction
+    Transaction *transaction = new Transaction(0);
+
+    // create and fetch header_page
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    (void)header_page;
+
+    std::vector<int64_t> keys;
+    for (int64_t key = 1; key <= 10000; key++) {
+      keys.push_back(key);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::default_random_engine(0));
+    for (auto key : keys) {
+      rid.Set(0, static_cast<uint32_t>(key));
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, rid, transaction);
+    }
+
+    std::vector<RID> rids;
+    for (auto key : keys) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      ASSERT_TRUE(tree.GetValue(index_key, &rids));
+      EXPECT_EQ(rids[0].GetSlotNum(), key);
+    }
+
+    int64_t current_key = 1;
+    for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+      EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+      current_key = current_key + 1;
+    }
+    EXPECT_EQ(current_key, keys.size() + 1);
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete key_schema;
+    delete transaction;
+    delete bpm;
+    delete disk_manager;
+    remove("test.db");
+    remove("test.log");
+  }
+}
+
 }  // namespace bustub
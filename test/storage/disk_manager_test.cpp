@@ -10,11 +10,28 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
 #include <cstring>
+#include <functional>
+#include <future>  // NOLINT
+#include <iostream>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
 #include "common/exception.h"
+#include "common/util/aligned_memory.h"
+#include "common/util/crc32c.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_latency.h"
+#include "storage/disk/disk_manager_memory.h"
 
 namespace bustub {
 
@@ -41,6 +58,671 @@ TEST(DiskManagerTest, ReadWritePageTest) {
   remove(db_file.c_str());
 }
 
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, WritePagesTest) {
+  const page_id_t page_ids[] = {7, 2, 1, 3};
+  char data[4][PAGE_SIZE] = {};
+  char buf[PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+
+  // Pages 1-3 go out in one run and page 7 in another, whatever the order they are handed in.
+  std::vector<std::pair<page_id_t, const char *>> pages;
+  for (int i = 0; i < 4; i++) {
+    snprintf(data[i], PAGE_SIZE, "page %d", page_ids[i]);
+    pages.emplace_back(page_ids[i], data[i]);
+  }
+  dm.WritePages(&pages);
+  dm.SyncPages();
+  EXPECT_EQ(4, dm.GetNumWrites());
+  EXPECT_EQ(1, pages[0].first);
+  EXPECT_EQ(7, pages[3].first);
+
+  for (int i = 0; i < 4; i++) {
+    dm.ReadPage(page_ids[i], buf);
+    EXPECT_EQ(std::memcmp(buf, data[i], sizeof(buf)), 0);
+  }
+  // The gap before page 7 reads back as zeros.
+  dm.ReadPage(5, buf);
+  EXPECT_EQ('\0', buf[0]);
+
+  dm.ShutDown();
+  remove(db_file.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, ConcurrentReadWritePageTest) {
+  const int num_threads = 8;
+  const int pages_per_thread = 64;
+  std::string db_file("test.db");
+  DiskManager dm(db_file);
+
+  // Every thread writes and reads back its own pages while the others do the same.
+  std::vector<std::thread> threads;
+  std::vector<int> mismatches(num_threads, 0);
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&dm, &mismatches, t] {
+      char data[PAGE_SIZE];
+      char buf[PAGE_SIZE];
+      for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < pages_per_thread; i++) {
+          page_id_t page_id = i * num_threads + t;
+          std::memset(data, 'a' + (page_id + round) % 26, sizeof(data));
+          dm.WritePage(page_id, data);
+          dm.ReadPage(page_id, buf);
+          mismatches[t] += std::memcmp(buf, data, sizeof(buf)) != 0 ? 1 : 0;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int t = 0; t < num_threads; t++) {
+    EXPECT_EQ(0, mismatches[t]);
+  }
+  EXPECT_EQ(num_threads * pages_per_thread * 4, dm.GetNumWrites());
+
+  dm.ShutDown();
+  remove(db_file.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, LargeFileTest) {
+  char buf[PAGE_SIZE] = {0};
+  char data[PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  std::strncpy(data, "beyond 2 GB", sizeof(data));
+
+  // The page starts past the range of an int offset; the file is sparse, so this costs no disk space.
+  const page_id_t page_id = (INT32_MAX / PAGE_SIZE) + 10;
+  {
+    DiskManager dm(db_file);
+    dm.WritePage(page_id, data);
+    dm.ReadPage(page_id, buf);
+    EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+    dm.ReadPage(page_id + 1, buf);
+    EXPECT_EQ('\0', buf[0]);
+    dm.ShutDown();
+  }
+  // A file over 2 GB opens again with its page size.
+  DiskManager dm(db_file);
+  dm.ReadPage(page_id, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  dm.ShutDown();
+  remove(db_file.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, AsyncReadWritePageTest) {
+  const int num_pages = 200;
+  std::string db_file("test.db");
+  DiskManager dm(db_file);
+  std::vector<std::vector<char>> data(num_pages, std::vector<char>(PAGE_SIZE));
+  std::vector<std::vector<char>> buf(num_pages, std::vector<char>(PAGE_SIZE, 'x'));
+
+  // Scenario: far more writes and reads than the queue depth are in flight from a single thread.
+  std::vector<std::future<bool>> writes;
+  for (int i = 0; i < num_pages; i++) {
+    snprintf(data[i].data(), PAGE_SIZE, "page %d", i);
+    writes.push_back(dm.WritePageAsync(i, data[i].data()));
+  }
+  for (auto &write : writes) {
+    EXPECT_TRUE(write.get());
+  }
+  std::vector<std::future<bool>> reads;
+  for (int i = 0; i < num_pages; i++) {
+    reads.push_back(dm.ReadPageAsync(i, buf[i].data()));
+  }
+  for (int i = 0; i < num_pages; i++) {
+    EXPECT_TRUE(reads[i].get());
+    EXPECT_EQ(data[i], buf[i]);
+  }
+  EXPECT_EQ(num_pages, dm.GetNumWrites());
+
+  // Scenario: a page beyond the end of the file reads as zeros.
+  EXPECT_TRUE(dm.ReadPageAsync(num_pages + 10, buf[0].data()).get());
+  EXPECT_EQ(std::vector<char>(PAGE_SIZE, '\0'), buf[0]);
+
+  dm.ShutDown();
+  remove(db_file.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, AsyncDiskIOBackendTest) {
+  std::string db_file("test.db");
+  int fd = open(db_file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  ASSERT_GE(fd, 0);
+
+  // Both backends write a vector of buffers to consecutive bytes and read it back; the read past the end is zeroed.
+  for (bool use_io_uring : {true, false}) {
+    auto io = AsyncDiskIO::Create(4, use_io_uring);
+    if (!use_io_uring) {
+      EXPECT_STREQ("thread pool", io->GetName());
+    }
+    std::vector<char> first(100, 'a');
+    std::vector<char> second(50, use_io_uring ? 'b' : 'c');
+    std::vector<std::future<bool>> writes;
+    for (off_t offset = 0; offset < 20 * 150; offset += 150) {
+      writes.push_back(io->Write(fd, {{first.data(), first.size()}, {second.data(), second.size()}}, offset));
+    }
+    for (auto &write : writes) {
+      EXPECT_TRUE(write.get());
+    }
+    std::vector<char> buf(200, 'x');
+    EXPECT_TRUE(io->Read(fd, {{buf.data(), buf.size()}}, 19 * 150).get());
+    EXPECT_EQ(first, std::vector<char>(buf.begin(), buf.begin() + 100));
+    EXPECT_EQ(second, std::vector<char>(buf.begin() + 100, buf.begin() + 150));
+    EXPECT_EQ(std::vector<char>(50, '\0'), std::vector<char>(buf.begin() + 150, buf.end()));
+  }
+
+  close(fd);
+  remove(db_file.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, DirectIOTest) {
+  std::string db_file("test.db");
+  DiskManager dm(db_file, PAGE_SIZE, true);
+  EXPECT_TRUE(dm.IsDirectIO());
+
+  // Scenario: aligned buffers go to the disk as they are, the async and batched calls included.
+  AlignedBuffer data = AlignedMemory::Allocate(3 * PAGE_SIZE);
+  AlignedBuffer buf = AlignedMemory::Allocate(PAGE_SIZE);
+  ASSERT_TRUE(AlignedMemory::IsAligned(data.get()));
+  for (int i = 0; i < 3; i++) {
+    snprintf(data.get() + i * PAGE_SIZE, PAGE_SIZE, "page %d", i);
+  }
+  dm.WritePage(0, data.get());
+  EXPECT_TRUE(dm.WritePageAsync(1, data.get() + PAGE_SIZE).get());
+  std::vector<std::pair<page_id_t, const char *>> pages{{2, data.get() + 2 * PAGE_SIZE}};
+  dm.WritePages(&pages);
+  dm.SyncPages();
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(dm.ReadPageAsync(i, buf.get()).get());
+    EXPECT_EQ(std::memcmp(buf.get(), data.get() + i * PAGE_SIZE, PAGE_SIZE), 0);
+  }
+
+  // Scenario: unaligned buffers are bounced through aligned ones by ReadPage and WritePage.
+  std::vector<char> unaligned(PAGE_SIZE + 1, 'u');
+  dm.WritePage(3, unaligned.data() + 1);
+  std::fill(unaligned.begin(), unaligned.end(), '\0');
+  dm.ReadPage(3, unaligned.data() + 1);
+  EXPECT_EQ(std::vector<char>(PAGE_SIZE, 'u'), std::vector<char>(unaligned.begin() + 1, unaligned.end()));
+  dm.ReadPage(0, unaligned.data() + 1);
+  EXPECT_EQ(std::memcmp(unaligned.data() + 1, data.get(), PAGE_SIZE), 0);
+
+  dm.ShutDown();
+  remove(db_file.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, AllocatePageTest) {
+  std::string db_file("test.db");
+  struct stat stat_buf;
+  {
+    DiskManager dm(db_file);
+    for (page_id_t page_id = 0; page_id < 10; page_id++) {
+      EXPECT_EQ(page_id, dm.AllocatePage());
+    }
+    // Scenario: the file grows by a whole extent, not page by page.
+    ASSERT_EQ(0, stat(db_file.c_str(), &stat_buf));
+    EXPECT_EQ(FILE_EXTENT_PAGES * PAGE_SIZE, stat_buf.st_size);
+
+    // Scenario: deallocated pages are reused, lowest first, before new ones.
+    dm.DeallocatePage(5);
+    dm.DeallocatePage(3);
+    EXPECT_FALSE(dm.IsPageAllocated(3));
+    EXPECT_EQ(3, dm.AllocatePage());
+    EXPECT_EQ(5, dm.AllocatePage());
+    EXPECT_EQ(10, dm.AllocatePage());
+    EXPECT_TRUE(dm.IsPageAllocated(5));
+
+    // Scenario: allocations cross the first extent and the first page of the map.
+    for (page_id_t page_id = 11; page_id < PAGE_SIZE * 8 + 10; page_id++) {
+      ASSERT_EQ(page_id, dm.AllocatePage());
+    }
+    ASSERT_EQ(0, stat(db_file.c_str(), &stat_buf));
+    EXPECT_EQ(0, stat_buf.st_size % (FILE_EXTENT_PAGES * PAGE_SIZE));
+    EXPECT_GE(stat_buf.st_size, (PAGE_SIZE * 8 + 10) * PAGE_SIZE);
+    dm.DeallocatePage(7);
+    dm.DeallocatePage(PAGE_SIZE * 8 + 1);
+    dm.ShutDown();
+  }
+
+  // Scenario: the map outlives the disk manager.
+  {
+    DiskManager dm(db_file);
+    EXPECT_TRUE(dm.IsPageAllocated(6));
+    EXPECT_EQ(7, dm.AllocatePage());
+    EXPECT_EQ(PAGE_SIZE * 8 + 1, dm.AllocatePage());
+    EXPECT_EQ(PAGE_SIZE * 8 + 10, dm.AllocatePage());
+    dm.ShutDown();
+  }
+
+  // Scenario: the map of a removed db file is not applied to a new one.
+  remove(db_file.c_str());
+  {
+    DiskManager dm(db_file);
+    EXPECT_FALSE(dm.IsPageAllocated(6));
+    EXPECT_EQ(0, dm.AllocatePage());
+
+    // Scenario: an id of a given remainder is the lowest free one with it; the ids before it stay free.
+    EXPECT_EQ(3, dm.AllocatePage(4, 3));
+    EXPECT_EQ(7, dm.AllocatePage(4, 3));
+    EXPECT_EQ(1, dm.AllocatePage());
+    EXPECT_EQ(2, dm.AllocatePage());
+    EXPECT_EQ(4, dm.AllocatePage());
+    dm.ShutDown();
+  }
+  remove(db_file.c_str());
+  remove("test.fsm");
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, ChecksumTest) {
+  std::string db_file("test.db");
+  AlignedBuffer data = AlignedMemory::Allocate(PAGE_SIZE);
+  AlignedBuffer buf = AlignedMemory::Allocate(PAGE_SIZE);
+  std::strncpy(data.get(), "A test string.", PAGE_SIZE);
+  DiskManager dm(db_file);
+
+  // Scenario: a page written while checksums are off carries none and is read without a check.
+  dm.WritePage(0, data.get());
+  enable_page_checksums = true;
+  EXPECT_NO_THROW(dm.ReadPage(0, buf.get()));
+
+  // Scenario: the checksum is stamped into the trailer and verified on every read path.
+  dm.WritePage(1, data.get());
+  uint32_t stamp;
+  std::memcpy(&stamp, data.get() + PAGE_SIZE - PAGE_CHECKSUM_SIZE, sizeof(stamp));
+  EXPECT_NE(0, stamp);
+  dm.ReadPage(1, buf.get());
+  EXPECT_EQ(std::memcmp(buf.get(), data.get(), PAGE_SIZE), 0);
+  EXPECT_TRUE(dm.ReadPageAsync(1, buf.get()).get());
+
+  // Scenario: a flipped bit on disk is caught by the synchronous and the asynchronous read.
+  int fd = open(db_file.c_str(), O_RDWR);
+  ASSERT_GE(fd, 0);
+  char byte = 'e' ^ 1;
+  ASSERT_EQ(1, pwrite(fd, &byte, 1, PAGE_SIZE + 3));
+  close(fd);
+  EXPECT_THROW(dm.ReadPage(1, buf.get()), Exception);
+  EXPECT_FALSE(dm.ReadPageAsync(1, buf.get()).get());
+  EXPECT_EQ(2, dm.GetNumChecksumFailures());
+
+  // Scenario: the batched and asynchronous writes stamp the checksum as well.
+  std::vector<std::pair<page_id_t, const char *>> pages{{1, data.get()}};
+  dm.WritePages(&pages);
+  EXPECT_NO_THROW(dm.ReadPage(1, buf.get()));
+  std::strncpy(data.get(), "Another test string.", PAGE_SIZE);
+  EXPECT_TRUE(dm.WritePageAsync(2, data.get()).get());
+  EXPECT_TRUE(dm.ReadPageAsync(2, buf.get()).get());
+  EXPECT_EQ(std::memcmp(buf.get(), data.get(), PAGE_SIZE), 0);
+
+  enable_page_checksums = false;
+  dm.ShutDown();
+  remove(db_file.c_str());
+}
+
+// Measures the cost of verifying checksums when reading pages from the OS page cache, the worst case for the overhead
+// since no device time hides it. Run with --gtest_also_run_disabled_tests.
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, DISABLED_ChecksumBenchmark) {
+  const size_t num_pages = 16384;
+  const size_t reads_per_gb = (1 << 30) / PAGE_SIZE;
+  std::string db_file("test.db");
+  AlignedBuffer data = AlignedMemory::Allocate(PAGE_SIZE);
+  std::memset(data.get(), 'x', PAGE_SIZE);
+  DiskManager dm(db_file);
+  enable_page_checksums = true;
+  for (size_t i = 0; i < num_pages; i++) {
+    dm.WritePage(static_cast<page_id_t>(i), data.get());
+  }
+
+  auto millis_per_gb = [&]() {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < reads_per_gb; i++) {
+      dm.ReadPage(static_cast<page_id_t>(i % num_pages), data.get());
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+  enable_page_checksums = false;
+  millis_per_gb();  // warm up the page cache
+  double without = millis_per_gb();
+  enable_page_checksums = true;
+  double with = millis_per_gb();
+  enable_page_checksums = false;
+
+  auto start = std::chrono::steady_clock::now();
+  uint32_t crc = 0;
+  for (size_t i = 0; i < reads_per_gb; i++) {
+    crc = Crc32c::Compute(data.get(), PAGE_SIZE, crc);
+  }
+  double kernel = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "read 1 GB: " << without << " ms without checksums, " << with << " ms with checksums ("
+            << (with - without) / without * 100 << "% overhead)" << std::endl
+            << "crc32c (" << (Crc32c::HasHardwareSupport() ? "sse4.2" : "software") << "): " << 1000 / kernel
+            << " GB/s, " << kernel * 1e6 / reads_per_gb << " ns per page (crc " << crc << ")" << std::endl;
+
+  dm.ShutDown();
+  remove(db_file.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, CompressionTest) {
+  std::string db_file("test.db");
+  const int num_pages = 100;
+  // Table pages of an archive: a header, free space, then rows of integers and short strings at the end.
+  auto MakePage = [](page_id_t page_id, std::vector<char> *page) {
+    std::fill(page->begin(), page->end(), '\0');
+    std::memcpy(page->data(), &page_id, sizeof(page_id));
+    size_t offset = PAGE_SIZE;
+    for (int row = 0; offset > PAGE_SIZE / 2; row++) {
+      char tuple[32];
+      int length = snprintf(tuple, sizeof(tuple), "%08d|%04d|item %d", page_id * 1000 + row, row % 7, row % 13);
+      offset -= length;
+      std::memcpy(page->data() + offset, tuple, length);
+    }
+  };
+  std::vector<char> data(PAGE_SIZE);
+  std::vector<char> buf(PAGE_SIZE);
+  struct stat stat_buf;
+  {
+    DiskManager dm(db_file, PAGE_SIZE, false, true);
+    EXPECT_TRUE(dm.IsCompressed());
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      EXPECT_EQ(page_id, dm.AllocatePage());
+      MakePage(page_id, &data);
+      dm.WritePage(page_id, data.data());
+    }
+    // Scenario: the pages take up a fraction of their size on disk and read back as written.
+    ASSERT_EQ(0, stat(db_file.c_str(), &stat_buf));
+    EXPECT_LT(stat_buf.st_size, num_pages * PAGE_SIZE / 2);
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      MakePage(page_id, &data);
+      dm.ReadPage(page_id, buf.data());
+      ASSERT_EQ(data, buf);
+    }
+    dm.ReadPage(num_pages, buf.data());
+    EXPECT_EQ(std::vector<char>(PAGE_SIZE, '\0'), buf);
+
+    // Scenario: a page that no longer compresses moves to a raw slot; the asynchronous calls work alike.
+    for (size_t i = 0; i < data.size(); i++) {
+      data[i] = static_cast<char>(i * 2654435761U >> 13);
+    }
+    EXPECT_TRUE(dm.WritePageAsync(7, data.data()).get());
+    EXPECT_TRUE(dm.ReadPageAsync(7, buf.data()).get());
+    EXPECT_EQ(data, buf);
+    dm.ShutDown();
+  }
+
+  // Scenario: the extent map outlives the disk manager, and a compressed file cannot be opened as a plain one.
+  EXPECT_THROW(DiskManager(db_file, PAGE_SIZE), Exception);
+  {
+    DiskManager dm(db_file, PAGE_SIZE, false, true);
+    dm.ReadPage(7, buf.data());
+    EXPECT_EQ(data, buf);
+    MakePage(8, &data);
+    dm.ReadPage(8, buf.data());
+    EXPECT_EQ(data, buf);
+
+    // Scenario: the slot of a deleted page is reused after a sync, so the file does not grow.
+    ASSERT_EQ(0, stat(db_file.c_str(), &stat_buf));
+    auto size = stat_buf.st_size;
+    dm.DeallocatePage(7);
+    dm.SyncPages();
+    dm.WritePage(7, buf.data());
+    dm.SyncPages();
+    ASSERT_EQ(0, stat(db_file.c_str(), &stat_buf));
+    EXPECT_EQ(size, stat_buf.st_size);
+    dm.ReadPage(7, buf.data());
+    EXPECT_EQ(data, buf);
+
+    // Scenario: a corrupt compressed page is reported instead of decompressed into garbage.
+    int fd = open(db_file.c_str(), O_RDWR);
+    ASSERT_GE(fd, 0);
+    char garbage[64];
+    std::memset(garbage, 0xf0, sizeof(garbage));
+    ASSERT_EQ(sizeof(garbage), pwrite(fd, garbage, sizeof(garbage), 4));
+    close(fd);
+    EXPECT_THROW(dm.ReadPage(0, buf.data()), Exception);
+    dm.ShutDown();
+  }
+  EXPECT_THROW(DiskManager(db_file, PAGE_SIZE, true, true), Exception);
+  remove(db_file.c_str());
+  remove("test.fsm");
+  remove("test.pmap");
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, TablespaceTest) {
+  mkdir("test_vol0", 0755);
+  mkdir("test_vol1", 0755);
+  std::vector<std::string> db_files{"test_vol0/test.db", "test_vol1/test.db"};
+  std::vector<char> data(PAGE_SIZE);
+  std::vector<char> buf(PAGE_SIZE);
+  auto fill = [&data](page_id_t page_id) {
+    for (size_t i = 0; i < data.size(); i++) {
+      data[i] = static_cast<char>(page_id * 31 + i);
+    }
+  };
+  struct stat stat_buf;
+  {
+    DiskManager dm(db_files);
+    EXPECT_EQ(2, dm.GetNumFiles());
+    for (page_id_t page_id = 0; page_id < 16; page_id++) {
+      EXPECT_EQ(page_id, dm.AllocatePage());
+    }
+    // Scenario: every file grows by one extent.
+    for (const auto &db_file : db_files) {
+      ASSERT_EQ(0, stat(db_file.c_str(), &stat_buf));
+      EXPECT_EQ(FILE_EXTENT_PAGES * PAGE_SIZE, stat_buf.st_size);
+    }
+
+    // Scenario: pages written one at a time, in a batch and asynchronously are striped across the files.
+    for (page_id_t page_id = 0; page_id < 6; page_id++) {
+      fill(page_id);
+      dm.WritePage(page_id, data.data());
+    }
+    std::vector<std::vector<char>> batch;
+    for (page_id_t page_id = 6; page_id < 14; page_id++) {
+      fill(page_id);
+      batch.push_back(data);
+    }
+    std::vector<std::pair<page_id_t, const char *>> pages;
+    for (page_id_t page_id = 6; page_id < 14; page_id++) {
+      pages.emplace_back(page_id, batch[page_id - 6].data());
+    }
+    dm.WritePages(&pages);
+    fill(14);
+    EXPECT_TRUE(dm.WritePageAsync(14, data.data()).get());
+    dm.SyncPages();
+
+    for (page_id_t page_id = 0; page_id < 15; page_id++) {
+      fill(page_id);
+      dm.ReadPage(page_id, buf.data());
+      ASSERT_EQ(data, buf) << page_id;
+    }
+    EXPECT_TRUE(dm.ReadPageAsync(13, buf.data()).get());
+    fill(13);
+    EXPECT_EQ(data, buf);
+
+    // Scenario: pages 4 to 7 are the first stripe of the second file, pages 8 to 11 the second stripe of the first.
+    for (page_id_t page_id : {5, 10}) {
+      int stripe = page_id / TABLESPACE_STRIPE_PAGES;
+      off_t file_page = stripe / 2 * TABLESPACE_STRIPE_PAGES + page_id % TABLESPACE_STRIPE_PAGES;
+      int fd = open(db_files[stripe % 2].c_str(), O_RDONLY);
+      ASSERT_GE(fd, 0);
+      ASSERT_EQ(PAGE_SIZE, pread(fd, buf.data(), PAGE_SIZE, file_page * PAGE_SIZE));
+      close(fd);
+      fill(page_id);
+      EXPECT_EQ(data, buf) << page_id;
+    }
+    dm.ShutDown();
+  }
+
+  // Scenario: the tablespace is reopened from the same files, and cannot be compressed.
+  {
+    DiskManager dm(db_files);
+    for (page_id_t page_id = 0; page_id < 15; page_id++) {
+      fill(page_id);
+      dm.ReadPage(page_id, buf.data());
+      ASSERT_EQ(data, buf) << page_id;
+    }
+    EXPECT_TRUE(dm.IsPageAllocated(15));
+    EXPECT_EQ(16, dm.AllocatePage());
+    dm.ShutDown();
+  }
+  EXPECT_THROW(DiskManager(db_files, PAGE_SIZE, false, true), Exception);
+  EXPECT_THROW(DiskManager(std::vector<std::string>{}), Exception);
+  remove(db_files[0].c_str());
+  remove(db_files[1].c_str());
+  remove("test_vol0/test.log");
+  remove("test_vol0/test.fsm");
+  remove("test_vol0/test.pmap");
+  rmdir("test_vol0");
+  rmdir("test_vol1");
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, MemoryBackendTest) {
+  DiskManagerMemory dm(2 * PAGE_SIZE);
+  DiskManager *disk_manager = &dm;
+  std::vector<char> data(2 * PAGE_SIZE);
+  std::vector<char> buf(2 * PAGE_SIZE, 'x');
+  EXPECT_EQ(2 * PAGE_SIZE, disk_manager->GetPageSize());
+  EXPECT_STREQ("memory", disk_manager->GetAsyncBackend());
+
+  // Scenario: a page that was never written reads as zeros, also in a chunk that does not exist yet.
+  disk_manager->ReadPage(100000, buf.data());
+  EXPECT_EQ(std::vector<char>(2 * PAGE_SIZE, '\0'), buf);
+
+  // Scenario: pages written one at a time, in a batch and asynchronously read back through the interface.
+  snprintf(data.data(), data.size(), "page 5");
+  disk_manager->WritePage(5, data.data());
+  disk_manager->ReadPage(5, buf.data());
+  EXPECT_EQ(data, buf);
+  std::vector<char> batch[2] = {std::vector<char>(2 * PAGE_SIZE, 'a'), std::vector<char>(2 * PAGE_SIZE, 'b')};
+  std::vector<std::pair<page_id_t, const char *>> pages{{3000, batch[1].data()}, {7, batch[0].data()}};
+  disk_manager->WritePages(&pages);
+  EXPECT_EQ(7, pages[0].first);
+  EXPECT_TRUE(disk_manager->ReadPageAsync(3000, buf.data()).get());
+  EXPECT_EQ(batch[1], buf);
+  EXPECT_TRUE(disk_manager->WritePageAsync(7, data.data()).get());
+  disk_manager->ReadPage(7, buf.data());
+  EXPECT_EQ(data, buf);
+  EXPECT_EQ(4, disk_manager->GetNumWrites());
+
+  // Scenario: pages are allocated from the bitmap as with the file backend.
+  EXPECT_EQ(0, disk_manager->AllocatePage());
+  EXPECT_EQ(1, disk_manager->AllocatePage());
+  disk_manager->DeallocatePage(0);
+  EXPECT_FALSE(disk_manager->IsPageAllocated(0));
+  EXPECT_EQ(0, disk_manager->AllocatePage());
+
+  // Scenario: the log is appended to and read back, zero-filled past its end.
+  char log[16] = "log record";
+  char log_buf[32];
+  EXPECT_FALSE(disk_manager->ReadLog(log_buf, sizeof(log_buf), 0));
+  disk_manager->WriteLog(log, sizeof(log));
+  disk_manager->WriteLog(log, sizeof(log) / 2);
+  EXPECT_EQ(2, disk_manager->GetNumFlushes());
+  EXPECT_TRUE(disk_manager->ReadLog(log_buf, sizeof(log_buf), 0));
+  EXPECT_STREQ("log record", log_buf);
+  EXPECT_STREQ("log reco", log_buf + sizeof(log));
+  EXPECT_FALSE(disk_manager->ReadLog(log_buf, sizeof(log_buf), sizeof(log) * 3 / 2));
+
+  // Scenario: the log before the truncation point can no longer be read.
+  disk_manager->TruncateLog(sizeof(log));
+  EXPECT_EQ(sizeof(log), disk_manager->GetLogBegin());
+  EXPECT_FALSE(disk_manager->ReadLog(log_buf, sizeof(log_buf), 0));
+  EXPECT_TRUE(disk_manager->ReadLog(log_buf, sizeof(log_buf), sizeof(log)));
+  EXPECT_STREQ("log reco", log_buf);
+
+  // Scenario: pages carry checksums like on disk.
+  enable_page_checksums = true;
+  disk_manager->WritePage(8, data.data());
+  disk_manager->ReadPage(8, buf.data());
+  EXPECT_EQ(data, buf);
+  enable_page_checksums = false;
+  disk_manager->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, LatencyBackendTest) {
+  using std::chrono::milliseconds;
+  DiskManagerMemory memory;
+  DiskLatencyModel model;
+  model.read_latency_ = std::chrono::microseconds(10000);
+  model.write_latency_ = std::chrono::microseconds(1000);
+  model.sync_latency_ = std::chrono::microseconds(3000);
+  model.queue_depth_ = 4;
+  DiskManagerLatency dm(&memory, model);
+  std::vector<char> data(PAGE_SIZE, 'd');
+  std::vector<char> buf(PAGE_SIZE);
+  auto elapsed = [](const std::function<void()> &call) {
+    auto start = std::chrono::steady_clock::now();
+    call();
+    return std::chrono::steady_clock::now() - start;
+  };
+
+  // Scenario: synchronous calls take their latency each, and the data goes through to the backend.
+  EXPECT_GE(elapsed([&] {
+              for (page_id_t page_id = 0; page_id < 4; page_id++) {
+                dm.WritePage(page_id, data.data());
+              }
+            }),
+            milliseconds(4));
+  EXPECT_GE(elapsed([&] { dm.ReadPage(2, buf.data()); }), milliseconds(10));
+  EXPECT_EQ(data, buf);
+  memory.ReadPage(3, buf.data());
+  EXPECT_EQ(data, buf);
+  EXPECT_EQ(4, dm.GetNumWrites());
+  EXPECT_STREQ("memory", dm.GetAsyncBackend());
+
+  // Scenario: asynchronous reads overlap up to the queue depth, so 8 of them take two latencies instead of eight.
+  auto async_reads = elapsed([&] {
+    std::vector<std::vector<char>> bufs(8, std::vector<char>(PAGE_SIZE));
+    std::vector<std::future<bool>> reads;
+    for (int i = 0; i < 8; i++) {
+      reads.push_back(dm.ReadPageAsync(i % 4, bufs[i].data()));
+    }
+    for (auto &read : reads) {
+      EXPECT_TRUE(read.get());
+    }
+  });
+  EXPECT_GE(async_reads, milliseconds(20));
+  EXPECT_LT(async_reads, milliseconds(60));
+
+  // Scenario: a batch pays the latency per run of adjacent pages, and a sync waits for the writes before it.
+  std::vector<std::pair<page_id_t, const char *>> pages;
+  for (page_id_t page_id : {10, 11, 12, 20, 21}) {
+    pages.emplace_back(page_id, data.data());
+  }
+  EXPECT_GE(elapsed([&] { dm.WritePages(&pages); }), milliseconds(1));
+  EXPECT_GE(elapsed([&] {
+              dm.WritePageAsync(30, data.data());
+              dm.SyncPages();
+            }),
+            milliseconds(4));
+
+  // Scenario: the bandwidth limits transfers, 10 pages at 1 page per ms take 10 ms without any latency.
+  DiskLatencyModel slow;
+  slow.bandwidth_ = PAGE_SIZE * 1000;
+  DiskManagerLatency slow_dm(&memory, slow);
+  pages.clear();
+  for (page_id_t page_id = 0; page_id < 10; page_id++) {
+    pages.emplace_back(page_id, data.data());
+  }
+  EXPECT_GE(elapsed([&] { slow_dm.WritePages(&pages); }), milliseconds(10));
+
+  // Scenario: a read from the modeled hard disk waits for the seek.
+  DiskManagerLatency hdd(&memory, DiskLatencyModel::Hdd());
+  EXPECT_GE(elapsed([&] { hdd.ReadPage(0, buf.data()); }), milliseconds(8));
+  dm.ShutDown();
+}
+
 TEST(DiskManagerTest, ReadWriteLogTest) {
   char buf[16] = {0};
   char data[16] = {0};
@@ -58,6 +740,132 @@ TEST(DiskManagerTest, ReadWriteLogTest) {
   remove(db_file.c_str());
 }
 
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, LogSegmentTest) {
+  const int record_size = 1000;
+  std::string db_file("test.db");
+  remove(db_file.c_str());
+  remove("test.log");
+  size_t segment_size = log_segment_size;
+  log_segment_size = 4096;
+  // Records start with their size, as log records do.
+  auto record = [&](int i) {
+    std::vector<char> data(record_size, static_cast<char>('a' + i % 26));
+    memcpy(data.data(), &record_size, sizeof(record_size));
+    return data;
+  };
+  // The log is written from two buffers in turn, as the log manager does.
+  std::vector<char> buffers[2];
+  auto write_record = [&](DiskManager *dm, int i) {
+    buffers[i % 2] = record(i);
+    dm->WriteLog(buffers[i % 2].data(), record_size);
+  };
+  std::vector<char> buf(record_size);
+  struct stat stat_buf;
+
+  // Scenario: the log runs on across preallocated segments, and records span them.
+  auto *dm = new DiskManager(db_file);
+  for (int i = 0; i < 10; i++) {
+    write_record(dm, i);
+  }
+  EXPECT_EQ(10 * record_size, dm->GetLogSize());
+  ASSERT_EQ(0, stat("test.log.2", &stat_buf));
+  EXPECT_EQ(4096, stat_buf.st_size);
+  EXPECT_TRUE(dm->ReadLog(buf.data(), record_size, 4 * record_size));
+  EXPECT_EQ(record(4), buf);
+
+  // Scenario: truncation releases the segments before the one it falls in, which are kept for reuse.
+  dm->TruncateLog(5 * record_size);
+  EXPECT_EQ(5 * record_size, dm->GetLogBegin());
+  EXPECT_FALSE(dm->ReadLog(buf.data(), record_size, 4 * record_size));
+  EXPECT_TRUE(dm->ReadLog(buf.data(), record_size, 5 * record_size));
+  EXPECT_EQ(record(5), buf);
+  EXPECT_NE(0, stat("test.log.0", &stat_buf));
+  EXPECT_EQ(0, stat("test.log.3", &stat_buf));
+
+  // Scenario: a crash right after truncation finds the log in the segments that are left.
+  {
+    DiskManager reopened(db_file);
+    EXPECT_EQ(5 * record_size, reopened.GetLogBegin());
+    EXPECT_EQ(10 * record_size, reopened.GetLogSize());
+    EXPECT_TRUE(reopened.ReadLog(buf.data(), record_size, 5 * record_size));
+    EXPECT_EQ(record(5), buf);
+    reopened.ShutDown();
+  }
+
+  // Scenario: after a crash, the manifest lags behind the log; the end is found by following the record sizes.
+  for (int i = 10; i < 14; i++) {
+    write_record(dm, i);
+  }
+  {
+    DiskManager reopened(db_file);
+    EXPECT_EQ(5 * record_size, reopened.GetLogBegin());
+    EXPECT_EQ(14 * record_size, reopened.GetLogSize());
+    EXPECT_TRUE(reopened.ReadLog(buf.data(), record_size, 13 * record_size));
+    EXPECT_EQ(record(13), buf);
+    reopened.ShutDown();
+  }
+  delete dm;
+
+  // Scenario: under sustained writes and checkpoints, the log takes up a bounded number of segment files.
+  DiskManager log_dm(db_file);
+  for (int i = 14; i < 214; i++) {
+    write_record(&log_dm, i);
+    if (i % 10 == 9) {
+      log_dm.TruncateLog(log_dm.GetLogSize());
+    }
+  }
+  EXPECT_EQ(214 * record_size, log_dm.GetLogSize());
+  int64_t last_segment = log_dm.GetLogSize() / 4096;
+  size_t num_segment_files = 0;
+  for (int64_t segment = 0; segment <= last_segment + static_cast<int64_t>(LOG_RECYCLED_SEGMENTS); segment++) {
+    num_segment_files += stat(("test.log." + std::to_string(segment)).c_str(), &stat_buf) == 0 ? 1 : 0;
+  }
+  EXPECT_LE(num_segment_files, 1 + LOG_RECYCLED_SEGMENTS);
+  log_dm.ShutDown();
+
+  log_segment_size = segment_size;
+  remove(db_file.c_str());
+  remove("test.log");
+  // A new log replaces the segments of the old one with a segment 0 of its own.
+  DiskManager(db_file).ShutDown();
+  for (int64_t segment = 1; segment <= last_segment + static_cast<int64_t>(LOG_RECYCLED_SEGMENTS); segment++) {
+    EXPECT_NE(0, stat(("test.log." + std::to_string(segment)).c_str(), &stat_buf));
+  }
+  remove(db_file.c_str());
+  remove("test.log");
+  remove("test.log.0");
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, PageSizeTest) {
+  std::string db_file("test.db");
+  EXPECT_THROW(DiskManager(db_file, 3000), Exception);
+  EXPECT_THROW(DiskManager(db_file, 2 * MAX_PAGE_SIZE), Exception);
+
+  // Pages 0 and 1 of a 16 KB file are one 32 KB page of another file.
+  std::vector<char> data(16384, 'x');
+  std::vector<char> buf(16384);
+  {
+    DiskManager dm(db_file, 16384);
+    EXPECT_EQ(16384, dm.GetPageSize());
+    dm.WritePage(1, data.data());
+    dm.ReadPage(1, buf.data());
+    EXPECT_EQ(data, buf);
+    dm.ShutDown();
+  }
+  EXPECT_NO_THROW(DiskManager(db_file, 32768));
+  // Page 4 of 8 KB leaves the file at 40 KB, which is no whole number of 16 KB pages.
+  {
+    DiskManager dm(db_file, 8192);
+    dm.WritePage(4, data.data());
+    dm.ShutDown();
+  }
+  EXPECT_THROW(DiskManager(db_file, 16384), Exception);
+  remove(db_file.c_str());
+  remove("test.log");
+}
+
 TEST(DiskManagerTest, ThrowBadFileTest) { EXPECT_THROW(DiskManager("dev/null\\/foo/bar/baz/test.db"), Exception); }
 
 }  // namespace bustub
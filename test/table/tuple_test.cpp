@@ -11,14 +11,18 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <chrono>  // NOLINT
 #include <cstdio>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "storage/disk/disk_manager_latency.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
 
@@ -71,4 +75,62 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// Scan throughput by page size, on the disk of the machine, in memory and on a modeled SSD and hard disk. Run with
+// --gtest_also_run_disabled_tests. The table is loaded into a pool that holds all of it, which is then shrunk to a
+// quarter of the table so that the scan reads from disk.
+// NOLINTNEXTLINE
+TEST(TupleTest, DISABLED_ScanThroughputBenchmark) {
+  const size_t table_bytes = 1 << 20;
+  Column col1{"a", TypeId::VARCHAR, 1000};
+  Column col2{"b", TypeId::BIGINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+  Tuple tuple({Value(TypeId::VARCHAR, std::string(1000, 'x')), Value(TypeId::BIGINT, static_cast<int64_t>(0))},
+              &schema);
+  const size_t num_tuples = table_bytes / (tuple.GetLength() + 8);
+
+  for (std::string backend : {"file", "memory", "ssd", "hdd"}) {
+    for (size_t page_size : {4096, 16384, 65536}) {
+      auto *transaction = new Transaction(0);
+      std::unique_ptr<DiskManager> storage;
+      std::unique_ptr<DiskManager> device;
+      if (backend == "file") {
+        storage = std::make_unique<DiskManager>("test.db", page_size);
+      } else {
+        storage = std::make_unique<DiskManagerMemory>(page_size);
+      }
+      if (backend == "ssd" || backend == "hdd") {
+        DiskLatencyModel model = backend == "ssd" ? DiskLatencyModel::Ssd() : DiskLatencyModel::Hdd();
+        device = std::make_unique<DiskManagerLatency>(storage.get(), model);
+      }
+      DiskManager *disk_manager = device != nullptr ? device.get() : storage.get();
+      auto *buffer_pool_manager = new BufferPoolManager(2 * table_bytes / page_size, disk_manager);
+      auto *table = new TableHeap(buffer_pool_manager, nullptr, nullptr, transaction);
+      RID rid;
+      for (size_t i = 0; i < num_tuples; ++i) {
+        ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+      }
+      buffer_pool_manager->FlushAllPages();
+      buffer_pool_manager->Resize(table_bytes / 4 / page_size);
+
+      size_t scanned = 0;
+      auto start = std::chrono::steady_clock::now();
+      for (auto itr = table->Begin(transaction); itr != table->End(); ++itr) {
+        scanned++;
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      EXPECT_EQ(num_tuples, scanned);
+      std::cout << backend << ", page size " << page_size / 1024 << " KB: " << scanned / elapsed.count()
+                << " tuples/s, " << table_bytes / elapsed.count() / (1 << 20) << " MB/s" << std::endl;
+
+      disk_manager->ShutDown();
+      remove("test.db");
+      remove("test.log");
+      delete table;
+      delete buffer_pool_manager;
+      delete transaction;
+    }
+  }
+}
+
 }  // namespace bustub
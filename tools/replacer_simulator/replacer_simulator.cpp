@@ -0,0 +1,180 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_simulator.cpp
+//
+// Identification: tools/replacer_simulator/replacer_simulator.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+// Replays a page access trace against every replacement policy at several pool sizes and reports the hit ratio and
+// the cost per access. Traces come from BufferPoolManager::StartTrace or from the synthetic generators:
+//
+//   replacer_simulator <trace_file> [pool_size ...]
+//   replacer_simulator --generate zipf|scan|loop <trace_file> [num_accesses]
+//
+// Without pool sizes, pools of 64, 256, 1024 and 4096 frames are simulated. The synthetic traces are sized so that
+// these are small and large compared to their working sets: 10000 pages with a Zipfian skew of 0.99, a hot set of
+// 1000 pages with a scan of 2000 pages every 10000 accesses, and a loop over 1000 pages.
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "buffer/arc_replacer.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "buffer/page_trace.h"
+#include "common/exception.h"
+
+namespace bustub {
+
+/** The outcome of replaying a trace against one policy at one pool size. */
+struct SimulationResult {
+  size_t hits_{0};
+  size_t misses_{0};
+  size_t new_pages_{0};
+  double nanos_per_access_{0};
+
+  /** @return hits / (hits + misses); new pages are neither */
+  double HitRatio() const { return hits_ + misses_ == 0 ? 0 : static_cast<double>(hits_) / (hits_ + misses_); }
+};
+
+/**
+ * Replays a trace the way the buffer pool drives its replacer: a resident page is pinned and unpinned, any other page
+ * is loaded into a free frame or the victim's and then pinned and unpinned. Pages are unpinned right away.
+ */
+static SimulationResult Simulate(const std::vector<PageAccess> &trace, size_t pool_size, Replacer *replacer) {
+  SimulationResult result;
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  std::vector<page_id_t> frame_pages(pool_size, INVALID_PAGE_ID);
+  std::list<frame_id_t> free_list;
+  for (size_t i = 0; i < pool_size; i++) {
+    free_list.push_back(static_cast<frame_id_t>(i));
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &access : trace) {
+    frame_id_t frame_id;
+    auto iter = page_table.find(access.page_id_);
+    if (iter != page_table.end()) {
+      result.hits_++;
+      frame_id = iter->second;
+    } else {
+      if (access.type_ == PageAccessType::NEW) {
+        result.new_pages_++;
+      } else {
+        result.misses_++;
+      }
+      if (!free_list.empty()) {
+        frame_id = free_list.front();
+        free_list.pop_front();
+      } else if (replacer->Victim(&frame_id)) {
+        page_table.erase(frame_pages[frame_id]);
+      } else {
+        throw Exception("replacer found no victim although no frame is pinned");
+      }
+      page_table[access.page_id_] = frame_id;
+      frame_pages[frame_id] = access.page_id_;
+      replacer->RecordPage(frame_id, access.page_id_);
+    }
+    replacer->Pin(frame_id);
+    replacer->Unpin(frame_id);
+  }
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  result.nanos_per_access_ = trace.empty() ? 0 : elapsed.count() / trace.size();
+  return result;
+}
+
+/** The policies to compare, by name. */
+static const std::vector<std::pair<std::string, std::function<std::unique_ptr<Replacer>(size_t)>>> &Policies() {
+  static const std::vector<std::pair<std::string, std::function<std::unique_ptr<Replacer>(size_t)>>> policies{
+      {"LRU", [](size_t pool_size) { return std::make_unique<LRUReplacer>(pool_size); }},
+      {"Clock", [](size_t pool_size) { return std::make_unique<ClockReplacer>(pool_size); }},
+      {"LRU-2", [](size_t pool_size) { return std::make_unique<LRUKReplacer>(pool_size, 2); }},
+      {"ARC", [](size_t pool_size) { return std::make_unique<ARCReplacer>(pool_size); }},
+  };
+  return policies;
+}
+
+static void Replay(const std::string &trace_file, std::vector<size_t> pool_sizes) {
+  std::vector<PageAccess> trace = PageTraceReader::ReadAll(trace_file);
+  std::unordered_set<page_id_t> distinct_pages;
+  for (const auto &access : trace) {
+    distinct_pages.insert(access.page_id_);
+  }
+  std::cout << trace_file << ": " << trace.size() << " accesses, " << distinct_pages.size() << " distinct pages"
+            << std::endl;
+  if (pool_sizes.empty()) {
+    pool_sizes = {64, 256, 1024, 4096};
+  }
+
+  printf("%-8s %10s %10s %12s\n", "policy", "pool size", "hit ratio", "ns/access");
+  for (size_t pool_size : pool_sizes) {
+    for (const auto &[name, make_replacer] : Policies()) {
+      auto replacer = make_replacer(pool_size);
+      SimulationResult result = Simulate(trace, pool_size, replacer.get());
+      printf("%-8s %10zu %10.4f %12.1f\n", name.c_str(), pool_size, result.HitRatio(), result.nanos_per_access_);
+    }
+  }
+}
+
+static void Generate(const std::string &kind, const std::string &trace_file, size_t num_accesses) {
+  std::vector<PageAccess> trace;
+  if (kind == "zipf") {
+    trace = PageTraceGenerator::Zipfian(10000, num_accesses, 0.99);
+  } else if (kind == "scan") {
+    trace = PageTraceGenerator::Scan(1000, 2000, 10000, num_accesses);
+  } else if (kind == "loop") {
+    trace = PageTraceGenerator::Loop(1000, num_accesses);
+  } else {
+    throw Exception("unknown trace kind " + kind + ", expected zipf, scan or loop");
+  }
+  PageTraceWriter writer(trace_file);
+  for (const auto &access : trace) {
+    writer.Record(access.page_id_, access.type_);
+  }
+  std::cout << "wrote " << trace.size() << " accesses to " << trace_file << std::endl;
+}
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " <trace_file> [pool_size ...]" << std::endl
+              << "       " << argv[0] << " --generate zipf|scan|loop <trace_file> [num_accesses]" << std::endl;
+    return 1;
+  }
+  try {
+    if (std::string(argv[1]) == "--generate") {
+      if (argc < 4) {
+        std::cerr << "usage: " << argv[0] << " --generate zipf|scan|loop <trace_file> [num_accesses]" << std::endl;
+        return 1;
+      }
+      bustub::Generate(argv[2], argv[3], argc > 4 ? std::stoul(argv[4]) : 1000000);
+      return 0;
+    }
+    std::vector<size_t> pool_sizes;
+    for (int i = 2; i < argc; i++) {
+      pool_sizes.push_back(std::stoul(argv[i]));
+    }
+    bustub::Replay(argv[1], pool_sizes);
+  } catch (const bustub::Exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}